@@ -3,30 +3,87 @@
 #include <cmath>
 #include <iomanip>
 #include <algorithm>
-#include <map>
 #include <ctime>
+#include <limits>
+#include "advanced_features.h"
 #include "models/Company.h"
 #include "database/DatabaseManager.h"
+#include "trace.h"
+#include "probe.h"
 
-// Estrutura para análise de crédito
-struct CreditAnalysis {
-    double creditScore;
-    double interestRate;
-    double maxLoanAmount;
-    std::string riskLevel;
-};
+// SSE2 faz parte da base x86-64 (MinGW e MSVC); nas outras plataformas usa-se o caminho escalar
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ADVANCED_FEATURES_SSE2 1
+#endif
 
-// Estrutura para parcelas
-struct Installment {
-    int number;
-    double value;
-    double principal;
-    double interest;
-    double remainingBalance;
-};
+namespace {
+    // Grelha do catálogo de produtos: taxas anuais dos níveis de risco × prazos até 30 anos
+    const double kCatalogRates[] = {0.05, 0.08, 0.12};
+    const int kCatalogRateCount = sizeof(kCatalogRates) / sizeof(kCatalogRates[0]);
+    const int kCatalogMaxMonths = 360;
+
+    // Prazo de referência usado para cotar a parcela do valor máximo na análise de crédito
+    const int kReferenceTermMonths = 12;
+
+    // Fator de anuidade (tabela Price); com taxa zero o capital é dividido em partes iguais
+    double exactAnnuityFactor(double monthlyRate, int months) {
+        if (monthlyRate == 0.0) return 1.0 / months;
+        double growth = pow(1 + monthlyRate, months);
+        return (monthlyRate * growth) / (growth - 1);
+    }
+
+    // Tabela construída na primeira cotação e partilhada por todas as seguintes
+    struct AnnuityTable {
+        double factors[kCatalogRateCount][kCatalogMaxMonths + 1];
+
+        AnnuityTable() {
+            TRACE_SCOPE("annuityTable.build");
+            for (int i = 0; i < kCatalogRateCount; i++) {
+                factors[i][0] = 0.0;
+                for (int n = 1; n <= kCatalogMaxMonths; n++) {
+                    factors[i][n] = exactAnnuityFactor(kCatalogRates[i] / 12, n);
+                }
+            }
+        }
+    };
+
+    const AnnuityTable& annuityTable() {
+        static const AnnuityTable table;
+        return table;
+    }
+
+    // Preenche as parcelas [first, months) a partir do saldo devedor informado
+    void fillSchedule(Installment* out, int first, int months, double payment,
+                      double monthlyRate, double remainingBalance) {
+        PROBE_SCOPE("fillSchedule");
+        for (int i = first; i < months; i++) {
+            Installment& inst = out[i];
+            inst.number = i + 1;
+            inst.value = payment;
+            inst.interest = remainingBalance * monthlyRate;
+            inst.principal = payment - inst.interest;
+            remainingBalance -= inst.principal;
+            inst.remainingBalance = remainingBalance;
+        }
+    }
+}
+
+// Fator de anuidade para uma taxa anual e um prazo em meses.
+// Combinações do catálogo são lidas da tabela; as restantes são calculadas na hora.
+double annuityFactor(double interestRate, int months) {
+    if (months <= 0) return 0.0;
+    if (months <= kCatalogMaxMonths) {
+        for (int i = 0; i < kCatalogRateCount; i++) {
+            if (interestRate == kCatalogRates[i]) return annuityTable().factors[i][months];
+        }
+    }
+    return exactAnnuityFactor(interestRate / 12, months);
+}
 
 // Função para calcular score de crédito
 CreditAnalysis calculateCreditScore(const Company& company, const std::vector<Company>& history) {
+    TRACE_SCOPE("calculateCreditScore");
     CreditAnalysis analysis;
     double baseScore = 700.0; // Score base
     
@@ -40,6 +97,7 @@ CreditAnalysis calculateCreditScore(const Company& company, const std::vector<Co
     // Análise de histórico
     int previousLoans = 0;
     int paidLoans = 0;
+    PROBE_SCOPE("calculateCreditScore.history");
     for (const auto& hist : history) {
         if (hist.getName() == company.getName()) {
             previousLoans++;
@@ -69,31 +127,89 @@ CreditAnalysis calculateCreditScore(const Company& company, const std::vector<Co
         analysis.riskLevel = "ALTO";
         analysis.maxLoanAmount = company.getLoanAmount();
     }
+    analysis.maxMonthlyPayment = analysis.maxLoanAmount * annuityFactor(analysis.interestRate, kReferenceTermMonths);
     
     return analysis;
 }
 
 // Função para calcular parcelas
 std::vector<Installment> calculateInstallments(double amount, double interestRate, int months) {
-    std::vector<Installment> installments;
-    double monthlyRate = interestRate / 12;
-    double payment = amount * (monthlyRate * pow(1 + monthlyRate, months)) / (pow(1 + monthlyRate, months) - 1);
-    double remainingBalance = amount;
-    
-    for (int i = 1; i <= months; i++) {
-        Installment inst;
-        inst.number = i;
-        inst.value = payment;
-        inst.interest = remainingBalance * monthlyRate;
-        inst.principal = payment - inst.interest;
-        remainingBalance -= inst.principal;
-        inst.remainingBalance = remainingBalance;
-        installments.push_back(inst);
-    }
-    
+    TRACE_SCOPE("calculateInstallments");
+    PROBE_SCOPE("calculateInstallments");
+    if (months <= 0) return {};
+    std::vector<Installment> installments(months);
+    fillSchedule(installments.data(), 0, months, amount * annuityFactor(interestRate, months),
+                 interestRate / 12, amount);
     return installments;
 }
 
+size_t installmentBufferSize(const int* months, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (months[i] > 0) total += months[i];
+    }
+    return total;
+}
+
+// Função para calcular parcelas em lote
+// A recorrência juros/amortização de cada empréstimo é sequencial, por isso a
+// vetorização é feita entre empréstimos: dois empréstimos avançam em paralelo
+// nas duas pistas de um registo SSE2 até ao menor dos prazos, e o restante
+// prazo do mais longo é concluído no caminho escalar.
+size_t calculateInstallmentsBatch(const double* amounts, const double* interestRates,
+                                  const int* months, size_t count, Installment* out) {
+    TRACE_SCOPE("calculateInstallmentsBatch");
+    PROBE_SCOPE("calculateInstallmentsBatch");
+    size_t offset = 0;
+    size_t i = 0;
+#ifdef ADVANCED_FEATURES_SSE2
+    for (; i + 2 <= count; i += 2) {
+        int m0 = std::max(months[i], 0);
+        int m1 = std::max(months[i + 1], 0);
+        double r0 = interestRates[i] / 12;
+        double r1 = interestRates[i + 1] / 12;
+        double p0 = amounts[i] * annuityFactor(interestRates[i], m0);
+        double p1 = amounts[i + 1] * annuityFactor(interestRates[i + 1], m1);
+        Installment* out0 = out + offset;
+        Installment* out1 = out0 + m0;
+        int common = std::min(m0, m1);
+
+        __m128d rate = _mm_set_pd(r1, r0);
+        __m128d payment = _mm_set_pd(p1, p0);
+        __m128d balance = _mm_set_pd(amounts[i + 1], amounts[i]);
+        for (int k = 0; k < common; k++) {
+            __m128d interest = _mm_mul_pd(balance, rate);
+            __m128d principal = _mm_sub_pd(payment, interest);
+            balance = _mm_sub_pd(balance, principal);
+
+            out0[k].number = k + 1;
+            out1[k].number = k + 1;
+            out0[k].value = p0;
+            out1[k].value = p1;
+            _mm_storel_pd(&out0[k].interest, interest);
+            _mm_storeh_pd(&out1[k].interest, interest);
+            _mm_storel_pd(&out0[k].principal, principal);
+            _mm_storeh_pd(&out1[k].principal, principal);
+            _mm_storel_pd(&out0[k].remainingBalance, balance);
+            _mm_storeh_pd(&out1[k].remainingBalance, balance);
+        }
+
+        double remaining[2];
+        _mm_storeu_pd(remaining, balance);
+        fillSchedule(out0, common, m0, p0, r0, remaining[0]);
+        fillSchedule(out1, common, m1, p1, r1, remaining[1]);
+        offset += m0 + m1;
+    }
+#endif
+    for (; i < count; i++) {
+        int m = std::max(months[i], 0);
+        fillSchedule(out + offset, 0, m, amounts[i] * annuityFactor(interestRates[i], m),
+                     interestRates[i] / 12, amounts[i]);
+        offset += m;
+    }
+    return offset;
+}
+
 // Função para mostrar análise de crédito
 void displayCreditAnalysis(const CreditAnalysis& analysis) {
     std::cout << "\n=== Análise de Crédito ===\n";
@@ -101,10 +217,11 @@ void displayCreditAnalysis(const CreditAnalysis& analysis) {
     std::cout << "Nível de Risco: " << analysis.riskLevel << "\n";
     std::cout << "Taxa de Juros: " << std::fixed << std::setprecision(2) << (analysis.interestRate * 100) << "%\n";
     std::cout << "Valor Máximo de Empréstimo: €" << std::fixed << std::setprecision(2) << analysis.maxLoanAmount << "\n";
+    std::cout << "Parcela do Valor Máximo (" << kReferenceTermMonths << "x): €" << std::fixed << std::setprecision(2) << analysis.maxMonthlyPayment << "\n";
 }
 
 // Função para mostrar tabela de parcelas
-void displayInstallments(const std::vector<Installment>& installments) {
+void displayInstallments(const Installment* installments, size_t count) {
     std::cout << "\n=== Tabela de Parcelas ===\n";
     std::cout << std::left
               << std::setw(8) << "Parcela"
@@ -115,7 +232,8 @@ void displayInstallments(const std::vector<Installment>& installments) {
               << "\n";
     std::cout << std::string(60, '-') << "\n";
     
-    for (const auto& inst : installments) {
+    for (size_t i = 0; i < count; i++) {
+        const Installment& inst = installments[i];
         std::cout << std::left
                   << std::setw(8) << inst.number
                   << std::fixed << std::setprecision(2)
@@ -127,46 +245,90 @@ void displayInstallments(const std::vector<Installment>& installments) {
     }
 }
 
+void displayInstallments(const std::vector<Installment>& installments) {
+    displayInstallments(installments.data(), installments.size());
+}
+
 // Função para análise de tendências
-void analyzeTrends(const std::vector<Company>& companies) {
+// A agregação é feita pelo banco de dados (DatabaseManager::getTrendReport)
+void analyzeTrends(const TrendReport& report) {
+    TRACE_SCOPE("analyzeTrends");
+    PROBE_SCOPE("analyzeTrends");
     std::cout << "\n=== Análise de Tendências ===\n";
     
-    // Análise por localização
-    std::map<std::string, int> locationCount;
-    std::map<std::string, double> locationTotal;
-    
-    for (const auto& company : companies) {
-        locationCount[company.getLocation()]++;
-        locationTotal[company.getLocation()] += company.getLoanAmount();
-    }
-    
     std::cout << "\nEmpréstimos por Localização:\n";
-    for (const auto& loc : locationCount) {
-        std::cout << loc.first << ": " << loc.second << " empréstimos"
+    for (const auto& loc : report.locations) {
+        std::cout << loc.location << ": " << loc.loanCount << " empréstimos"
                   << " (Total: €" << std::fixed << std::setprecision(2) 
-                  << locationTotal[loc.first] << ")\n";
-    }
-    
-    // Análise de valores
-    double totalAmount = 0;
-    double maxAmount = 0;
-    double minAmount = std::numeric_limits<double>::max();
-    
-    for (const auto& company : companies) {
-        totalAmount += company.getLoanAmount();
-        maxAmount = std::max(maxAmount, company.getLoanAmount());
-        minAmount = std::min(minAmount, company.getLoanAmount());
+                  << loc.totalAmount << ")\n";
     }
     
     std::cout << "\nEstatísticas de Valores:\n";
+    if (report.amounts.loanCount == 0) {
+        std::cout << "Nenhum empréstimo registrado.\n";
+        return;
+    }
     std::cout << "Média: €" << std::fixed << std::setprecision(2) 
-              << (totalAmount / companies.size()) << "\n";
-    std::cout << "Maior: €" << maxAmount << "\n";
-    std::cout << "Menor: €" << minAmount << "\n";
+              << report.amounts.averageAmount << "\n";
+    std::cout << "Maior: €" << report.amounts.maxAmount << "\n";
+    std::cout << "Menor: €" << report.amounts.minAmount << "\n";
+}
+
+// Função para relatório de originação por período
+void showOriginationReport(DatabaseManager& dbManager) {
+    TRACE_SCOPE("showOriginationReport");
+    std::string fromDate, toDate;
+    std::cout << "\n=== Originação de Empréstimos por Período ===\n\n";
+    std::cout << "Data inicial (AAAA-MM-DD): ";
+    std::getline(std::cin, fromDate);
+    std::cout << "Data final (AAAA-MM-DD): ";
+    std::getline(std::cin, toDate);
+    // As datas são validadas pelo DatabaseManager
+    std::vector<OriginationBucket> buckets;
+    if (!dbManager.getOriginationReport(fromDate, toDate, buckets)) {
+        std::cout << "\nPeríodo inválido!\n";
+        return;
+    }
+    if (buckets.empty()) {
+        std::cout << "\nNenhum empréstimo originado no período.\n";
+        return;
+    }
+    
+    std::cout << "\n" << std::left
+              << std::setw(10) << "Mês"
+              << std::setw(14) << "Empréstimos"
+              << std::setw(18) << "Volume (€)"
+              << std::setw(14) << "Inadimplentes"
+              << "\n";
+    std::cout << std::string(56, '-') << "\n";
+    
+    int totalCount = 0;
+    int totalDefaults = 0;
+    double totalVolume = 0.0;
+    for (const auto& bucket : buckets) {
+        std::cout << std::left
+                  << std::setw(10) << bucket.period
+                  << std::setw(14) << bucket.loanCount
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(18) << bucket.loanVolume
+                  << std::setw(14) << bucket.defaultCount
+                  << "\n";
+        totalCount += bucket.loanCount;
+        totalVolume += bucket.loanVolume;
+        totalDefaults += bucket.defaultCount;
+    }
+    std::cout << std::string(56, '-') << "\n";
+    std::cout << std::left
+              << std::setw(10) << "Total"
+              << std::setw(14) << totalCount
+              << std::setw(18) << totalVolume
+              << std::setw(14) << totalDefaults
+              << "\n";
 }
 
 // Função para simulação de empréstimo
 void simulateLoan() {
+    TRACE_SCOPE("simulateLoan");
     double amount;
     int months;
     
@@ -178,22 +340,34 @@ void simulateLoan() {
     
     // Simulação com diferentes taxas
     std::cout << "\nSimulação com diferentes taxas de juros:\n";
-    std::vector<double> rates = {0.05, 0.08, 0.12}; // 5%, 8%, 12%
+    const double rates[] = {0.05, 0.08, 0.12}; // 5%, 8%, 12%
+    const size_t rateCount = sizeof(rates) / sizeof(rates[0]);
+    double amounts[rateCount];
+    int terms[rateCount];
+    for (size_t i = 0; i < rateCount; i++) {
+        amounts[i] = amount;
+        terms[i] = months;
+    }
     
-    for (double rate : rates) {
-        std::cout << "\nTaxa de " << (rate * 100) << "% ao ano:\n";
-        auto installments = calculateInstallments(amount, rate, months);
-        displayInstallments(installments);
+    // As três tabelas são calculadas numa única chamada, num só buffer
+    std::vector<Installment> schedules(installmentBufferSize(terms, rateCount));
+    calculateInstallmentsBatch(amounts, rates, terms, rateCount, schedules.data());
+    
+    size_t perRate = schedules.size() / rateCount;
+    for (size_t i = 0; i < rateCount; i++) {
+        std::cout << "\nTaxa de " << (rates[i] * 100) << "% ao ano:\n";
+        displayInstallments(schedules.data() + i * perRate, perRate);
     }
 }
 
 // Função para menu de funcionalidades avançadas
-void showAdvancedMenu() {
+void showAdvancedMenu(DatabaseManager& dbManager) {
     while (true) {
         std::cout << "\n=== Menu Avançado ===\n\n";
         std::cout << "1. Análise de Crédito\n";
         std::cout << "2. Simulação de Empréstimo\n";
         std::cout << "3. Análise de Tendências\n";
+        std::cout << "4. Originação por Período\n";
         std::cout << "0. Voltar\n";
         std::cout << "Escolha uma opção: ";
         
@@ -232,7 +406,6 @@ void showAdvancedMenu() {
                 Company tempCompany(name, nipc, location, employeeName, amount);
                 
                 // Obtém todas as empresas do banco para análise comparativa
-                DatabaseManager dbManager("database/bank.db");
                 auto allCompanies = dbManager.getAllCompanies();
                 
                 // Realiza a análise de crédito
@@ -245,12 +418,12 @@ void showAdvancedMenu() {
             case 2:
                 simulateLoan();
                 break;
-            case 3: {
-                DatabaseManager dbManager("database/bank.db");
-                auto companies = dbManager.getAllCompanies();
-                analyzeTrends(companies);
+            case 3:
+                analyzeTrends(dbManager.getTrendReport());
+                break;
+            case 4:
+                showOriginationReport(dbManager);
                 break;
-            }
             case 0:
                 return;
             default:
@@ -3,27 +3,44 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
 #include "models/Company.h"
+#include "models/Installment.h"
+#include "models/Report.h"
 
+class DatabaseManager;
+
+// Estrutura para análise de crédito
 struct CreditAnalysis {
-    int score;
+    double creditScore;
+    double interestRate;
+    double maxLoanAmount;
+    double maxMonthlyPayment;
     std::string riskLevel;
-    std::string recommendation;
 };
 
-struct Installment {
-    int number;
-    double amount;
-    double interest;
-    double total;
-};
+// Fator de anuidade (parcela por euro emprestado) para uma taxa anual e um prazo.
+// A grelha de taxas e prazos do catálogo é pré-calculada no primeiro uso.
+double annuityFactor(double interestRate, int months);
 
-CreditAnalysis calculateCreditScore(const Company& company, const std::vector<Company>& allCompanies);
+CreditAnalysis calculateCreditScore(const Company& company, const std::vector<Company>& history);
 std::vector<Installment> calculateInstallments(double amount, double interestRate, int months);
+
+// Cálculo em lote das tabelas de parcelas (carteiras com muitos empréstimos).
+// As parcelas do empréstimo i são escritas de forma contígua em `out`, logo a seguir
+// às do empréstimo i-1; `out` deve ter espaço para installmentBufferSize(months, count)
+// parcelas. Não aloca memória. Retorna o número de parcelas escritas.
+size_t installmentBufferSize(const int* months, size_t count);
+size_t calculateInstallmentsBatch(const double* amounts, const double* interestRates,
+                                  const int* months, size_t count, Installment* out);
+
 void displayCreditAnalysis(const CreditAnalysis& analysis);
+void displayInstallments(const Installment* installments, size_t count);
 void displayInstallments(const std::vector<Installment>& installments);
-void analyzeTrends(const std::vector<Company>& companies);
+void analyzeTrends(const TrendReport& report);
+void showOriginationReport(DatabaseManager& dbManager);
 void simulateLoan();
-void showAdvancedMenu();
+// Usa a conexão de quem chama (pode ser só de leitura: o menu não escreve no banco)
+void showAdvancedMenu(DatabaseManager& dbManager);
 
-#endif // ADVANCED_FEATURES_H 
\ No newline at end of file
+#endif // ADVANCED_FEATURES_H
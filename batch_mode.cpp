@@ -0,0 +1,282 @@
+#include "batch_mode.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "advanced_features.h"
+#include "trace.h"
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t end = line.find(';', start);
+        fields.push_back(trim(line.substr(start, end - start)));
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    return fields;
+}
+
+bool parseAmount(const std::string& text, double& amount) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    amount = std::strtod(text.c_str(), &end);
+    return *end == '\0' && isValidAmount(amount);
+}
+
+bool parseMonths(const std::string& text, int& months) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || value < 1 || value > 360) return false;
+    months = static_cast<int>(value);
+    return true;
+}
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                        << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+CommandResult fail(CommandResult result, const std::string& error) {
+    result.success = false;
+    result.error = error;
+    return result;
+}
+
+} // namespace
+
+bool isValidAmount(double amount) {
+    return std::isfinite(amount) && amount > 0;
+}
+
+CommandResult depositCommand(DatabaseManager& dbManager, const std::string& nipc, double amount) {
+    CommandResult result;
+    result.command = "deposito";
+    result.nipc = nipc;
+    result.amount = amount;
+    if (!isValidAmount(amount)) return fail(result, "valor inválido");
+
+    Company company = dbManager.getCompany(nipc);
+    if (company.getName().empty()) return fail(result, "empresa não encontrada");
+    result.name = company.getName();
+    if (!dbManager.updateCompanyBalance(nipc, amount)) return fail(result, "erro ao atualizar o saldo");
+    result.balance = company.getBalance() + amount;
+    result.success = true;
+    return result;
+}
+
+CommandResult paymentCommand(DatabaseManager& dbManager, const std::string& nipc, double amount) {
+    CommandResult result;
+    result.command = "pagamento";
+    result.nipc = nipc;
+    result.amount = amount;
+    if (!isValidAmount(amount)) return fail(result, "valor inválido");
+
+    Company company = dbManager.getCompany(nipc);
+    if (company.getName().empty()) return fail(result, "empresa não encontrada");
+    result.name = company.getName();
+    if (company.getBalance() >= 0) return fail(result, "a empresa não possui dívida para pagar");
+    // Mesmo limite do menu: o pagamento nunca ultrapassa a dívida
+    result.amount = std::min(amount, -company.getBalance());
+    if (!dbManager.updateCompanyBalance(nipc, result.amount)) return fail(result, "erro ao atualizar o saldo");
+    result.balance = company.getBalance() + result.amount;
+    result.success = true;
+    return result;
+}
+
+CommandResult loanCommand(DatabaseManager& dbManager, const std::string& nipc, double amount, int months) {
+    CommandResult result;
+    result.command = "emprestimo";
+    result.nipc = nipc;
+    result.amount = amount;
+    if (!isValidAmount(amount)) return fail(result, "valor inválido");
+    if (months < 1 || months > 360) return fail(result, "número de parcelas inválido (1 a 360)");
+
+    Company company = dbManager.getCompany(nipc);
+    if (company.getName().empty()) return fail(result, "empresa não encontrada");
+    result.name = company.getName();
+    if (!dbManager.addLoanToCompany(nipc, amount)) return fail(result, "erro ao registrar o empréstimo");
+    double rate = dbManager.getCompanyInterestRate(nipc);
+    if (!dbManager.scheduleInstallments(nipc, calculateInstallments(amount, rate, months))) {
+        return fail(result, "erro ao gravar as parcelas");
+    }
+    result.balance = company.getBalance() - amount;
+    result.success = true;
+    return result;
+}
+
+CommandResult executeCommand(DatabaseManager& dbManager, const std::string& line) {
+    TRACE_SCOPE("executeCommand");
+    std::vector<std::string> fields = splitFields(line);
+    CommandResult result;
+    result.command = fields[0];
+
+    if (result.command == "deposito" || result.command == "pagamento") {
+        if (fields.size() != 3) return fail(result, "uso: " + result.command + ";NIPC;valor");
+        result.nipc = fields[1];
+        if (!parseAmount(fields[2], result.amount)) return fail(result, "valor inválido");
+        return result.command == "deposito" ? depositCommand(dbManager, result.nipc, result.amount)
+                                            : paymentCommand(dbManager, result.nipc, result.amount);
+    }
+
+    if (result.command == "emprestimo") {
+        if (fields.size() != 4) return fail(result, "uso: emprestimo;NIPC;valor;parcelas");
+        result.nipc = fields[1];
+        int months = 0;
+        if (!parseAmount(fields[2], result.amount)) return fail(result, "valor inválido");
+        if (!parseMonths(fields[3], months)) return fail(result, "número de parcelas inválido (1 a 360)");
+        return loanCommand(dbManager, result.nipc, result.amount, months);
+    }
+
+    if (result.command == "saldo" || result.command == "empresa") {
+        if (fields.size() != 2) return fail(result, "uso: " + result.command + ";" +
+                                                  (result.command == "saldo" ? "NIPC" : "NIPC ou nome"));
+        Company company = result.command == "saldo" ? dbManager.getCompany(fields[1])
+                                                    : dbManager.getCompanyByNipcOrName(fields[1]);
+        if (company.getName().empty()) return fail(result, "empresa não encontrada");
+        result.nipc = company.getNIPC();
+        result.name = company.getName();
+        result.balance = company.getBalance();
+        result.success = true;
+        return result;
+    }
+
+    return fail(result, "comando desconhecido");
+}
+
+CommandResult runAtomically(DatabaseManager& dbManager, const std::string& command,
+                            const std::function<CommandResult()>& run) {
+    if (!dbManager.savepoint("cmd")) {
+        CommandResult result;
+        result.command = command;
+        return fail(result, "erro ao iniciar o comando");
+    }
+    CommandResult result = run();
+    if (!result.success) {
+        dbManager.rollbackToSavepoint("cmd");
+    } else if (!dbManager.releaseSavepoint("cmd")) {
+        dbManager.rollbackToSavepoint("cmd");
+        return fail(result, "erro ao gravar o comando");
+    }
+    return result;
+}
+
+CommandResult executeCommandAtomically(DatabaseManager& dbManager, const std::string& line) {
+    return runAtomically(dbManager, splitFields(line)[0], [&]() { return executeCommand(dbManager, line); });
+}
+
+bool isReadOnlyCommand(const std::string& line) {
+    std::string command = splitFields(line)[0];
+    return command == "saldo" || command == "empresa";
+}
+
+std::string formatCommandResult(size_t lineNumber, const CommandResult& result) {
+    std::ostringstream out;
+    out << "{\"line\": " << lineNumber << ", \"command\": ";
+    writeJsonString(out, result.command);
+    out << ", \"ok\": " << (result.success ? "true" : "false");
+    if (!result.nipc.empty()) {
+        out << ", \"nipc\": ";
+        writeJsonString(out, result.nipc);
+    }
+    if (result.success) {
+        out << ", \"name\": ";
+        writeJsonString(out, result.name);
+        out << std::fixed << std::setprecision(2);
+        if (result.amount > 0) out << ", \"amount\": " << result.amount;
+        out << ", \"balance\": " << result.balance;
+    } else {
+        out << ", \"error\": ";
+        writeJsonString(out, result.error);
+    }
+    out << "}";
+    return out.str();
+}
+
+int runBatch(DatabaseManager& dbManager, std::istream& in, std::ostream& out, size_t commitEvery) {
+    TRACE_SCOPE("runBatch");
+    auto start = std::chrono::steady_clock::now();
+    size_t executed = 0;
+    size_t failed = 0;
+    size_t pending = 0;
+    size_t lineNumber = 0;
+    // Os resultados só são escritos depois de a transação que os contém ser gravada
+    std::string pendingOutput;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::string command = trim(line);
+        if (command.empty() || command[0] == '#') continue;
+
+        if (pending == 0 && !dbManager.beginTransaction()) {
+            std::cerr << "Erro ao iniciar transação na linha " << lineNumber << ".\n";
+            return 1;
+        }
+        // Um comando que falha não deixa alterações na transação
+        CommandResult result = executeCommandAtomically(dbManager, command);
+        pendingOutput += formatCommandResult(lineNumber, result);
+        pendingOutput += '\n';
+        executed++;
+        if (!result.success) failed++;
+
+        if (++pending == commitEvery) {
+            if (!dbManager.commitTransaction()) {
+                dbManager.rollbackTransaction();
+                std::cerr << "Erro ao gravar a transação terminada na linha " << lineNumber
+                          << "; os últimos " << pending << " comandos foram desfeitos.\n";
+                return 1;
+            }
+            out << pendingOutput;
+            pendingOutput.clear();
+            pending = 0;
+        }
+    }
+    if (pending > 0 && !dbManager.commitTransaction()) {
+        dbManager.rollbackTransaction();
+        std::cerr << "Erro ao gravar a última transação; os últimos " << pending << " comandos foram desfeitos.\n";
+        return 1;
+    }
+    out << pendingOutput;
+    out.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << executed << " comandos (" << (executed - failed) << " ok, " << failed << " com erro) em "
+              << std::fixed << std::setprecision(3) << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " (" << std::setprecision(0) << executed / seconds << " ops/s)";
+    }
+    std::cerr << "\n";
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef BATCH_MODE_H
+#define BATCH_MODE_H
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include "database/DatabaseManager.h"
+
+// Comandos do modo batch, um por linha, com os campos separados por ';':
+//
+//   deposito;NIPC;valor
+//   pagamento;NIPC;valor               (limitado à dívida, como no menu)
+//   emprestimo;NIPC;valor;parcelas     (empresa já cadastrada)
+//   saldo;NIPC
+//   empresa;NIPC ou nome
+//
+// Linhas vazias e linhas iniciadas por '#' são ignoradas.
+
+struct CommandResult {
+    bool success = false;
+    std::string command;
+    std::string nipc;
+    std::string name;
+    double amount = 0.0;   // valor efetivamente aplicado
+    double balance = 0.0;  // saldo da empresa após o comando
+    std::string error;
+};
+
+CommandResult executeCommand(DatabaseManager& dbManager, const std::string& line);
+// Como executeCommand, dentro de um savepoint: um comando que falha a meio (por exemplo,
+// empréstimo gravado mas parcelas não) é desfeito por inteiro
+CommandResult executeCommandAtomically(DatabaseManager& dbManager, const std::string& line);
+
+// Comandos de escrita com os argumentos já lidos (o protocolo binário do bank_daemon usa-os
+// sem passar por texto); as regras são as mesmas das linhas equivalentes
+CommandResult depositCommand(DatabaseManager& dbManager, const std::string& nipc, double amount);
+CommandResult paymentCommand(DatabaseManager& dbManager, const std::string& nipc, double amount);
+CommandResult loanCommand(DatabaseManager& dbManager, const std::string& nipc, double amount, int months);
+// Executa run dentro de um savepoint, desfeito se o comando falhar
+CommandResult runAtomically(DatabaseManager& dbManager, const std::string& command,
+                            const std::function<CommandResult()>& run);
+
+// Valor aceite num depósito, pagamento ou empréstimo: finito e positivo
+bool isValidAmount(double amount);
+
+// Comandos que só leem (saldo, empresa) e podem correr fora da conexão de escrita
+bool isReadOnlyCommand(const std::string& line);
+
+// Resultado em JSON numa linha (lineNumber é a linha do comando na entrada)
+std::string formatCommandResult(size_t lineNumber, const CommandResult& result);
+
+// Executa os comandos de `in` e escreve um resultado JSON por linha em `out`.
+// Os comandos são agrupados em transações de commitEvery operações; os resultados
+// de uma transação só são escritos depois de ela ser gravada.
+// Devolve 0 se todas as transações foram gravadas (comandos inválidos não contam).
+int runBatch(DatabaseManager& dbManager, std::istream& in, std::ostream& out, size_t commitEvery = 1000);
+
+#endif // BATCH_MODE_H
@@ -0,0 +1,389 @@
+/**
+ * @file bench_main.cpp
+ * @brief Microbenchmarks do DatabaseManager e das funcionalidades avançadas
+ * @details Para cada tamanho de base (número de empresas) cria um banco temporário,
+ *          executa cada operação várias vezes e grava em JSON as latências p50/p99,
+ *          as operações por segundo e as alocações de memória por operação, para
+ *          comparar duas execuções com um diff. Grava também o espaço ocupado pelas
+ *          tabelas companies e tasks e pelos seus índices (se o SQLite tiver dbstat).
+ *
+ *          Uso: bank_bench [--sizes 1000,10000,100000] [--iterations 2000]
+ *                          [--seed 42] [--profile default] [--output resultados.json]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "database/ActivityLog.h"
+#include "database/DatabaseManager.h"
+#include "advanced_features.h"
+#include "tools/PortfolioGenerator.h"
+
+namespace {
+
+// Alocações feitas pelo operator new global (contadas para mostrar a pressão sobre o alocador)
+std::atomic<long long> allocationCount{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Versões alinhadas (usadas, por exemplo, pelos memory_resource de std::pmr): o endereço
+// devolvido por malloc fica guardado logo antes do bloco alinhado
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw) throw std::bad_alloc();
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* aligned = reinterpret_cast<void*>((start + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    if (memory) std::free(static_cast<void**>(memory)[-1]);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
+
+namespace {
+
+struct BenchOptions {
+    std::vector<long long> sizes = {1000, 10000, 100000};
+    int iterations = 2000;
+    unsigned seed = 42;
+    // Perfil de durabilidade das conexões medidas (DatabaseOptions.h)
+    DatabaseOptions database;
+    std::string outputPath;
+};
+
+struct BenchResult {
+    std::string name;
+    long long rows;
+    int iterations;
+    double p50Ns;
+    double p99Ns;
+    double opsPerSec;
+    double allocationsPerOp;
+};
+
+// Bytes de uma tabela ou índice numa base de `rows` empresas
+struct StorageSize {
+    std::string name;
+    long long rows;
+    long long bytes;
+};
+
+// Histórico máximo passado a calculateCreditScore (a função percorre o vetor inteiro)
+const long long kMaxCreditHistory = 100000;
+
+// Executa op `iterations` vezes (após algumas de aquecimento) e resume as latências
+BenchResult measure(const std::string& name, long long rows, int iterations, const std::function<void()>& op) {
+    for (int i = 0; i < std::min(iterations, 3); i++) op();
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    auto total = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        op();
+        samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - total).count();
+    long long allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    std::sort(samples.begin(), samples.end());
+    BenchResult result;
+    result.name = name;
+    result.rows = rows;
+    result.iterations = iterations;
+    result.p50Ns = samples[samples.size() / 2];
+    result.p99Ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    result.opsPerSec = totalSeconds > 0 ? iterations / totalSeconds : 0.0;
+    result.allocationsPerOp = static_cast<double>(allocations) / iterations;
+
+    std::cerr << "  " << name << ": p50 " << static_cast<long long>(result.p50Ns) << " ns, p99 "
+              << static_cast<long long>(result.p99Ns) << " ns, " << static_cast<long long>(result.opsPerSec) << " ops/s, "
+              << std::setprecision(1) << std::fixed << result.allocationsPerOp << " alocações/op\n";
+    return result;
+}
+
+// Espaço das tabelas companies e tasks e dos seus índices, lido da tabela virtual dbstat
+// (disponível quando o SQLite é compilado com SQLITE_ENABLE_DBSTAT_VTAB)
+void measureStorage(const std::string& path, long long rows, std::vector<StorageSize>& sizes) {
+    const char* sql = "SELECT name, SUM(pgsize) FROM dbstat WHERE name IN "
+                      "(SELECT name FROM sqlite_master WHERE tbl_name IN ('companies', 'tasks')) "
+                      "GROUP BY name ORDER BY name;";
+    sqlite3* db;
+    sqlite3_stmt* stmt;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK
+        || sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "  tamanho dos índices indisponível: " << sqlite3_errmsg(db) << "\n";
+        sqlite3_close(db);
+        return;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        StorageSize size;
+        size.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        size.rows = rows;
+        size.bytes = sqlite3_column_int64(stmt, 1);
+        std::cerr << "  " << size.name << ": " << size.bytes / 1024 << " KiB\n";
+        sizes.push_back(size);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+void runSize(long long rows, const BenchOptions& options, std::vector<BenchResult>& results,
+             std::vector<StorageSize>& sizes) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("bank_bench_" + std::to_string(rows) + ".db");
+    std::filesystem::remove(path);
+
+    std::cerr << "Preparando base com " << rows << " empresas...\n";
+    PortfolioOptions portfolio;
+    portfolio.companies = rows;
+    portfolio.tasks = rows;
+    portfolio.seed = options.seed;
+    if (!generatePortfolio(path.string(), portfolio)) {
+        std::cerr << "Erro ao preparar base " << path << "\n";
+        return;
+    }
+    measureStorage(path.string(), rows, sizes);
+
+    {
+        DatabaseManager dbManager(path.string(), options.database);
+        std::mt19937_64 rng(options.seed);
+        auto randomIndex = [&]() { return static_cast<long long>(rng() % rows); };
+        int points = options.iterations;
+        // Varreduras completas: menos repetições conforme a base cresce
+        int scans = static_cast<int>(std::max(5LL, std::min<long long>(points, 2000000 / rows)));
+
+        results.push_back(measure("getCompany", rows, points, [&]() {
+            dbManager.getCompany(portfolioNipc(randomIndex()));
+        }));
+        results.push_back(measure("getCompanyByNipcOrName", rows, points, [&]() {
+            dbManager.getCompanyByNipcOrName(portfolioCompanyName(randomIndex()));
+        }));
+        results.push_back(measure("updateCompanyBalance", rows, points, [&]() {
+            dbManager.updateCompanyBalance(portfolioNipc(randomIndex()), 1.0);
+        }));
+        results.push_back(measure("getCompanyTasks", rows, points, [&]() {
+            TaskResultSet tasks;
+            dbManager.getCompanyTasks(portfolioNipc(randomIndex()), tasks);
+        }));
+        results.push_back(measure("createTask", rows, points, [&]() {
+            dbManager.createTask(Task("Tarefa de benchmark", portfolioNipc(randomIndex())));
+        }));
+        // Transação com dez depósitos: mostra o custo do commit em cada perfil
+        results.push_back(measure("commitTransaction (10 updates)", rows, points, [&]() {
+            dbManager.beginTransaction();
+            for (int i = 0; i < 10; i++) {
+                dbManager.updateCompanyBalance(portfolioNipc(randomIndex()), 1.0);
+            }
+            dbManager.commitTransaction();
+        }));
+        results.push_back(measure("getAllCompanies", rows, scans, [&]() {
+            dbManager.getAllCompanies();
+        }));
+        results.push_back(measure("getAllCompanies (arena)", rows, scans, [&]() {
+            CompanyResultSet companies;
+            dbManager.getAllCompanies(companies);
+        }));
+        results.push_back(measure("getAllTasks", rows, scans, [&]() {
+            dbManager.getAllTasks();
+        }));
+        results.push_back(measure("getAllTasks (arena)", rows, scans, [&]() {
+            TaskResultSet tasks;
+            dbManager.getAllTasks(tasks);
+        }));
+        results.push_back(measure("getTotalEmprestado", rows, scans, [&]() {
+            dbManager.getTotalEmprestado();
+        }));
+        results.push_back(measure("getTotalRecebido", rows, scans, [&]() {
+            dbManager.getTotalRecebido();
+        }));
+        results.push_back(measure("getSaldoGeral", rows, scans, [&]() {
+            dbManager.getSaldoGeral();
+        }));
+        results.push_back(measure("getEmpresasInadimplentes", rows, scans, [&]() {
+            dbManager.getEmpresasInadimplentes();
+        }));
+        results.push_back(measure("getTrendReport", rows, scans, [&]() {
+            dbManager.getTrendReport();
+        }));
+
+        std::vector<Company> history = dbManager.getAllCompanies();
+        if (static_cast<long long>(history.size()) > kMaxCreditHistory) history.resize(kMaxCreditHistory);
+        Company applicant(portfolioCompanyName(randomIndex()), portfolioNipc(randomIndex()), "Lisboa", "Ana", 25000.0);
+        results.push_back(measure("calculateCreditScore", static_cast<long long>(history.size()), scans, [&]() {
+            calculateCreditScore(applicant, history);
+        }));
+        results.push_back(measure("calculateInstallments", rows, points, [&]() {
+            calculateInstallments(25000.0, 0.08, 60);
+        }));
+    }
+
+    // Pesquisa no índice do NIPC com uma instrução preparada uma única vez e numa transação
+    // de leitura: mede o índice sem o custo de preparar a consulta e de obter o lock
+    {
+        sqlite3* db;
+        sqlite3_stmt* stmt = nullptr;
+        std::mt19937_64 rng(options.seed);
+        if (sqlite3_open_v2(path.string().c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK
+            && sqlite3_prepare_v2(db, "SELECT id FROM companies WHERE nipc = ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+            results.push_back(measure("nipcIndexLookup", rows, options.iterations * 10, [&]() {
+                sqlite3_bind_int64(stmt, 1, portfolioNipcValue(static_cast<long long>(rng() % rows)));
+                sqlite3_step(stmt);
+                sqlite3_reset(stmt);
+            }));
+            sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+    }
+
+    // Registo de atividades: o custo de pôr um registo no anel e o de um depósito registado
+    // (comparar com updateCompanyBalance, medido com o registo fechado)
+    std::filesystem::path logPath = std::filesystem::temp_directory_path() / ("bank_bench_" + std::to_string(rows) + ".log");
+    std::filesystem::remove(logPath);
+    if (ActivityLog::instance().open(logPath.string())) {
+        results.push_back(measure("activityLogRecord", rows, options.iterations * 10, [&]() {
+            ActivityLog::instance().record(ActivityType::BalanceChange, 500000000, 1.0);
+        }));
+        DatabaseManager dbManager(path.string(), options.database);
+        std::mt19937_64 rng(options.seed);
+        results.push_back(measure("updateCompanyBalance (registo)", rows, options.iterations, [&]() {
+            dbManager.updateCompanyBalance(portfolioNipc(static_cast<long long>(rng() % rows)), 1.0);
+        }));
+        ActivityLog::instance().close();
+    }
+    std::filesystem::remove(logPath);
+
+    // Arranque com o banco já na versão atual do esquema
+    results.push_back(measure("openDatabase", rows, std::min(options.iterations, 200), [&]() {
+        DatabaseManager reopened(path.string(), options.database);
+    }));
+
+    std::filesystem::remove(path);
+}
+
+std::string toJson(const BenchOptions& options, const std::vector<BenchResult>& results,
+                   const std::vector<StorageSize>& sizes) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"suite\": \"bank_bench\",\n";
+    json << "  \"sqlite_version\": \"" << sqlite3_libversion() << "\",\n";
+    json << "  \"seed\": " << options.seed << ",\n";
+    json << "  \"iterations\": " << options.iterations << ",\n";
+    json << "  \"profile\": \"" << options.database.profile << "\",\n";
+    json << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        json << "    {\"name\": \"" << r.name << "\", \"rows\": " << r.rows
+             << ", \"iterations\": " << r.iterations
+             << ", \"p50_ns\": " << static_cast<long long>(r.p50Ns)
+             << ", \"p99_ns\": " << static_cast<long long>(r.p99Ns)
+             << ", \"ops_per_sec\": " << static_cast<long long>(r.opsPerSec)
+             << ", \"allocations_per_op\": " << std::setprecision(1) << std::fixed << r.allocationsPerOp << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ],\n";
+    json << "  \"storage\": [\n";
+    for (size_t i = 0; i < sizes.size(); i++) {
+        json << "    {\"name\": \"" << sizes[i].name << "\", \"rows\": " << sizes[i].rows
+             << ", \"bytes\": " << sizes[i].bytes << "}" << (i + 1 < sizes.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+    return json.str();
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (arg == "--sizes") {
+            options.sizes.clear();
+            std::stringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                long long size = std::atoll(item.c_str());
+                if (size <= 0) return false;
+                options.sizes.push_back(size);
+            }
+        } else if (arg == "--iterations") {
+            options.iterations = std::atoi(value.c_str());
+            if (options.iterations <= 0) return false;
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--profile") {
+            if (!databaseProfile(value, options.database)) return false;
+        } else if (arg == "--output") {
+            options.outputPath = value;
+        } else {
+            return false;
+        }
+    }
+    return !options.sizes.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Uso: bank_bench [--sizes 1000,10000,100000] [--iterations N] [--seed S]\n"
+                  << "                 [--profile " << databaseProfileNames() << "] [--output arquivo.json]\n";
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    std::vector<StorageSize> sizes;
+    for (long long rows : options.sizes) {
+        runSize(rows, options, results, sizes);
+    }
+
+    std::string json = toJson(options, results, sizes);
+    if (options.outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(options.outputPath);
+        if (!out) {
+            std::cerr << "Erro ao gravar " << options.outputPath << "\n";
+            return 1;
+        }
+        out << json;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file teller_load.cpp
+ * @brief Gerador de carga multi-thread para o DatabaseManager (postos de atendimento)
+ * @details Cada thread simula um posto com a sua própria conexão e executa uma mistura de
+ *          consultas, depósitos, pagamentos, novos empréstimos e operações de tarefas.
+ *          Com --rate, as chegadas seguem um processo de Poisson com essa taxa total
+ *          (laço aberto): a latência conta desde o instante previsto de chegada, pelo que
+ *          um sistema saturado mostra a fila e não só o tempo de serviço. Com --rate 0 cada
+ *          thread executa as operações seguidas (laço fechado).
+ *          Sem --database gera uma carteira temporária; com --database o arquivo deve ter
+ *          sido gerado pelo generate_portfolio com os mesmos --companies e --tasks.
+ *
+ *          Uso: bank_teller_load [--threads 8] [--rate 2000] [--duration 10]
+ *                                [--mix lookup=60,deposit=15,payment=10,loan=5,task=10]
+ *                                [--profile teller] [--companies 10000] [--tasks 20000]
+ *                                [--seed 42] [--database arquivo.db]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "database/DatabaseManager.h"
+#include "database/QueryStats.h"
+#include "tools/PortfolioGenerator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum Operation { Lookup, Deposit, Payment, Loan, TaskOp, kOperationCount };
+const char* kOperationNames[kOperationCount] = {"lookup", "deposit", "payment", "loan", "task"};
+
+struct LoadOptions {
+    int threads = 8;
+    double rate = 2000;
+    double durationSeconds = 10;
+    double mix[kOperationCount] = {60, 15, 10, 5, 10};
+    DatabaseOptions database;
+    long long companies = 10000;
+    long long tasks = 20000;
+    unsigned long long seed = 42;
+    std::string databasePath;
+};
+
+// Resultados de uma thread, juntados no fim
+struct TellerResult {
+    bool connected = true;
+    std::vector<double> latencyUs[kOperationCount];
+    long long failed[kOperationCount] = {};
+};
+
+// Executa uma operação de atendimento sobre a empresa de índice `company`
+bool execute(DatabaseManager& dbManager, Operation operation, long long company,
+             std::mt19937_64& rng, const LoadOptions& options) {
+    std::string nipc = portfolioNipc(company);
+    switch (operation) {
+        case Lookup:
+            return !dbManager.getCompanyByNipcOrName(nipc).getName().empty();
+        case Deposit:
+            return dbManager.updateCompanyBalance(nipc, 100.0);
+        case Payment: {
+            // Como no menu: lê o saldo e paga até ao valor da dívida
+            Company found = dbManager.getCompany(nipc);
+            if (found.getName().empty()) return false;
+            if (found.getBalance() >= 0) return true;
+            return dbManager.updateCompanyBalance(nipc, std::min(100.0, -found.getBalance()));
+        }
+        case Loan:
+            return dbManager.addLoanToCompany(nipc, 5000.0);
+        case TaskOp:
+            if (options.tasks == 0 || rng() % 2 == 0) {
+                return dbManager.createTask(Task("Atendimento ao balcão", nipc));
+            }
+            return dbManager.updateTaskStatus(static_cast<int>(rng() % options.tasks) + 1, rng() % 2 == 0);
+        default:
+            return false;
+    }
+}
+
+void runTeller(int index, const LoadOptions& options, const std::string& path,
+               Clock::time_point start, Clock::time_point end, TellerResult& result) {
+    DatabaseManager dbManager(path, options.database);
+    if (!dbManager.isConnectedToDatabase()) {
+        result.connected = false;
+        return;
+    }
+    std::mt19937_64 rng(options.seed + static_cast<unsigned long long>(index));
+    std::discrete_distribution<int> pick(options.mix, options.mix + kOperationCount);
+    std::exponential_distribution<double> gap(options.rate > 0 ? options.rate / options.threads : 1.0);
+
+    Clock::time_point arrival = start;
+    while (true) {
+        if (options.rate > 0) {
+            arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng)));
+            if (arrival >= end) break;
+            // Se a thread estiver atrasada a operação começa logo, e o atraso conta na latência
+            std::this_thread::sleep_until(arrival);
+        } else {
+            arrival = Clock::now();
+            if (arrival >= end) break;
+        }
+        auto operation = static_cast<Operation>(pick(rng));
+        long long company = static_cast<long long>(rng() % static_cast<unsigned long long>(options.companies));
+        bool ok = execute(dbManager, operation, company, rng, options);
+        result.latencyUs[operation].push_back(std::chrono::duration<double, std::micro>(Clock::now() - arrival).count());
+        if (!ok) result.failed[operation]++;
+    }
+}
+
+// lookup=60,deposit=15,...: pesos relativos; operações omitidas ficam com peso 0
+bool parseMix(const std::string& text, double* mix) {
+    std::fill(mix, mix + kOperationCount, 0.0);
+    std::stringstream list(text);
+    std::string item;
+    double total = 0;
+    while (std::getline(list, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) return false;
+        std::string name = item.substr(0, equals);
+        auto found = std::find(kOperationNames, kOperationNames + kOperationCount, name);
+        if (found == kOperationNames + kOperationCount) return false;
+        double weight = std::atof(item.c_str() + equals + 1);
+        if (weight < 0) return false;
+        mix[found - kOperationNames] = weight;
+        total += weight;
+    }
+    return total > 0;
+}
+
+bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (arg == "--threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "--rate") {
+            options.rate = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            options.durationSeconds = std::atof(value.c_str());
+        } else if (arg == "--mix") {
+            if (!parseMix(value, options.mix)) return false;
+        } else if (arg == "--profile") {
+            if (!databaseProfile(value, options.database)) return false;
+        } else if (arg == "--companies") {
+            options.companies = std::atoll(value.c_str());
+        } else if (arg == "--tasks") {
+            options.tasks = std::atoll(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--database") {
+            options.databasePath = value;
+        } else {
+            return false;
+        }
+    }
+    return options.threads > 0 && options.rate >= 0 && options.durationSeconds > 0
+        && options.companies > 0 && options.tasks >= 0;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[static_cast<size_t>(p / 100.0 * (sorted.size() - 1))];
+}
+
+void printRow(const char* name, std::vector<double>& latencies, long long failed) {
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::left << std::setw(10) << name << std::right
+              << std::setw(10) << latencies.size()
+              << std::setw(8) << failed
+              << std::setw(12) << percentile(latencies, 50)
+              << std::setw(12) << percentile(latencies, 99)
+              << std::setw(12) << percentile(latencies, 99.9)
+              << std::setw(12) << (latencies.empty() ? 0.0 : latencies.back()) << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    databaseProfile("teller", options.database);
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Uso: bank_teller_load [--threads N] [--rate op/s] [--duration s]\n"
+                     "                        [--mix lookup=60,deposit=15,payment=10,loan=5,task=10]\n"
+                     "                        [--profile " << databaseProfileNames() << "]\n"
+                     "                        [--companies N] [--tasks M] [--seed S] [--database arquivo.db]\n";
+        return 1;
+    }
+    if (options.database.inMemory) {
+        std::cerr << "O perfil memory dá a cada thread uma cópia própria do banco; use outro perfil.\n";
+        return 1;
+    }
+
+    std::string path = options.databasePath;
+    bool temporary = path.empty();
+    if (temporary) {
+        path = (std::filesystem::temp_directory_path() / "bank_teller_load.db").string();
+        std::filesystem::remove(path);
+        std::cerr << "Preparando base com " << options.companies << " empresas e " << options.tasks << " tarefas...\n";
+        PortfolioOptions portfolio;
+        portfolio.companies = options.companies;
+        portfolio.tasks = options.tasks;
+        portfolio.seed = options.seed;
+        if (!generatePortfolio(path, portfolio)) {
+            std::cerr << "Erro ao preparar base " << path << "\n";
+            return 1;
+        }
+    }
+    {
+        // Aplica o journal_mode do perfil antes de as threads abrirem as suas conexões
+        DatabaseManager setup(path, options.database);
+        if (!setup.isConnectedToDatabase()) return 1;
+        std::cout << "Perfil: " << setup.databaseSettings() << "\n";
+    }
+
+    std::cout << options.threads << " postos, " << (options.rate > 0 ? std::to_string(static_cast<long long>(options.rate)) + " op/s (laço aberto)" : std::string("laço fechado"))
+              << ", " << options.durationSeconds << " s\n";
+
+    std::vector<TellerResult> results(static_cast<size_t>(options.threads));
+    std::vector<std::thread> tellers;
+    uint64_t busyBefore = QueryStats::instance().busyRetries();
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.durationSeconds));
+    for (int i = 0; i < options.threads; i++) {
+        tellers.emplace_back(runTeller, i, std::cref(options), std::cref(path), start, end, std::ref(results[static_cast<size_t>(i)]));
+    }
+    for (auto& teller : tellers) teller.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t busyRetries = QueryStats::instance().busyRetries() - busyBefore;
+
+    std::vector<double> all;
+    long long totalFailed = 0;
+    std::cout << "\n" << std::left << std::setw(10) << "operação" << std::right
+              << std::setw(10) << "total" << std::setw(8) << "falhas"
+              << std::setw(12) << "p50 µs" << std::setw(12) << "p99 µs"
+              << std::setw(12) << "p99.9 µs" << std::setw(12) << "máx µs" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (int op = 0; op < kOperationCount; op++) {
+        std::vector<double> latencies;
+        long long failed = 0;
+        for (auto& result : results) {
+            if (!result.connected) {
+                std::cerr << "Uma das threads não conseguiu abrir " << path << "\n";
+                return 1;
+            }
+            latencies.insert(latencies.end(), result.latencyUs[op].begin(), result.latencyUs[op].end());
+            failed += result.failed[op];
+        }
+        if (latencies.empty()) continue;
+        all.insert(all.end(), latencies.begin(), latencies.end());
+        totalFailed += failed;
+        printRow(kOperationNames[op], latencies, failed);
+    }
+    printRow("total", all, totalFailed);
+
+    std::cout << "\n" << all.size() << " operações em " << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << all.size() / seconds << " op/s)\n";
+    std::cout << "Esperas por lock (SQLITE_BUSY): " << busyRetries << "\n";
+
+    if (temporary) {
+        for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    }
+    return totalFailed == 0 ? 0 : 1;
+}
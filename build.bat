@@ -3,7 +3,7 @@ echo Compilando SQLite...
 gcc -c -o sqlite3.o sqlite3/include/sqlite3.c -I./sqlite3/include
 
 echo Compilando o sistema bancario...
-g++ -o bank_system_new.exe main.cpp database/DatabaseManager.cpp models/Company.cpp models/Task.cpp task_list.cpp advanced_features.cpp sqlite3.o -I. -I./sqlite3/include
+g++ -o bank_system_new.exe main.cpp database/ActivityLog.cpp database/DatabaseManager.cpp database/DatabaseOptions.cpp database/QueryStats.cpp models/Company.cpp models/Nipc.cpp models/StringPool.cpp models/Task.cpp probe.cpp trace.cpp task_list.cpp table_renderer.cpp batch_mode.cpp advanced_features.cpp sqlite3.o -I. -I./sqlite3/include
 if %errorlevel% equ 0 (
     echo Compilacao concluida com sucesso!
     echo Para executar, use: .\bank_system_new.exe
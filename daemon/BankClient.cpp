@@ -0,0 +1,169 @@
+#include "BankClient.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Tamanho do cabeçalho de uma resposta: u8 opcode | u32 id | u8 status
+const size_t kResponseHeader = 6;
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+BankClient::BankClient(const std::string& socketPath) : fd(-1), nextId(1) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || !sendAll(fd, std::string(protocol::kMagic, sizeof(protocol::kMagic)))) {
+        disconnect();
+    }
+}
+
+BankClient::~BankClient() {
+    disconnect();
+}
+
+void BankClient::disconnect() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+protocol::Status BankClient::call(protocol::FrameWriter& request, std::string& payload) {
+    if (fd < 0 || !sendAll(fd, request.finish())) {
+        disconnect();
+        return protocol::Status::Failed;
+    }
+    size_t offset = 0;
+    bool tooLarge = false;
+    char chunk[4096];
+    while (!protocol::nextFrame(buffer, offset, payload, tooLarge)) {
+        ssize_t n = tooLarge ? 0 : ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            disconnect();
+            return protocol::Status::Failed;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    buffer.erase(0, offset);
+    if (payload.size() < kResponseHeader) {
+        disconnect();
+        return protocol::Status::Failed;
+    }
+    return static_cast<protocol::Status>(static_cast<uint8_t>(payload[kResponseHeader - 1]));
+}
+
+protocol::Status BankClient::findCompany(const std::string& nipcOrName, Company& company) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::FindCompany));
+    request.u32(nextId++);
+    request.str(nipcOrName);
+    std::string payload;
+    protocol::Status status = call(request, payload);
+    if (status != protocol::Status::Ok) return status;
+
+    protocol::FrameReader response(payload.data() + kResponseHeader, payload.size() - kResponseHeader);
+    std::string name = response.str();
+    std::string nipc = response.str();
+    std::string location = response.str();
+    std::string employeeName = response.str();
+    double loanAmount = response.f64();
+    double balance = response.f64();
+    if (!response.ok()) return protocol::Status::Failed;
+    company = Company(name, nipc, location, employeeName, loanAmount);
+    company.setBalance(balance);
+    return status;
+}
+
+protocol::Status BankClient::deposit(const std::string& nipc, double amount, double& balance) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::UpdateCompanyBalance));
+    request.u32(nextId++);
+    request.str(nipc);
+    request.f64(amount);
+    std::string payload;
+    protocol::Status status = call(request, payload);
+    if (status != protocol::Status::Ok) return status;
+
+    // A resposta do depósito não traz o saldo; a consulta seguinte já vê o depósito
+    Company company;
+    status = findCompany(nipc, company);
+    if (status == protocol::Status::Ok) balance = company.getBalance();
+    return status;
+}
+
+protocol::Status BankClient::pay(const std::string& nipc, double amount, double& paid, double& balance) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::Payment));
+    request.u32(nextId++);
+    request.str(nipc);
+    request.f64(amount);
+    std::string payload;
+    protocol::Status status = call(request, payload);
+    if (status != protocol::Status::Ok) return status;
+
+    protocol::FrameReader response(payload.data() + kResponseHeader, payload.size() - kResponseHeader);
+    paid = response.f64();
+    balance = response.f64();
+    return response.ok() ? status : protocol::Status::Failed;
+}
+
+protocol::Status BankClient::addLoan(const std::string& nipc, double amount, int months, double& balance) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::Loan));
+    request.u32(nextId++);
+    request.str(nipc);
+    request.f64(amount);
+    request.u32(static_cast<uint32_t>(months));
+    std::string payload;
+    protocol::Status status = call(request, payload);
+    if (status != protocol::Status::Ok) return status;
+
+    protocol::FrameReader response(payload.data() + kResponseHeader, payload.size() - kResponseHeader);
+    balance = response.f64();
+    return response.ok() ? status : protocol::Status::Failed;
+}
+
+protocol::Status BankClient::createTask(const std::string& nipc, const std::string& description) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::CreateTask));
+    request.u32(nextId++);
+    request.str(nipc);
+    request.str(description);
+    std::string payload;
+    return call(request, payload);
+}
+
+protocol::Status BankClient::getReport(double& totalLent, double& totalReceived, double& overallBalance) {
+    protocol::FrameWriter request;
+    request.u8(static_cast<uint8_t>(protocol::Opcode::GetReport));
+    request.u32(nextId++);
+    std::string payload;
+    protocol::Status status = call(request, payload);
+    if (status != protocol::Status::Ok) return status;
+
+    protocol::FrameReader response(payload.data() + kResponseHeader, payload.size() - kResponseHeader);
+    totalLent = response.f64();
+    totalReceived = response.f64();
+    overallBalance = response.f64();
+    return response.ok() ? status : protocol::Status::Failed;
+}
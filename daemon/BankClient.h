@@ -0,0 +1,42 @@
+#ifndef BANK_CLIENT_H
+#define BANK_CLIENT_H
+
+#include <cstdint>
+#include <string>
+#include "BinaryProtocol.h"
+#include "models/Company.h"
+
+// Cliente do protocolo binário do bank_daemon, usado pelo bank_system --daemon: um pedido
+// de cada vez, à espera da resposta. Se a ligação cair, os pedidos seguintes devolvem
+// Failed e isConnected() passa a falso.
+class BankClient {
+public:
+    explicit BankClient(const std::string& socketPath);
+    ~BankClient();
+    BankClient(const BankClient&) = delete;
+    BankClient& operator=(const BankClient&) = delete;
+
+    bool isConnected() const { return fd >= 0; }
+
+    // Empresa por NIPC ou nome, com o saldo atual
+    protocol::Status findCompany(const std::string& nipcOrName, Company& company);
+    // Depósito; balance recebe o saldo depois dele
+    protocol::Status deposit(const std::string& nipc, double amount, double& balance);
+    // Pagamento limitado à dívida; paid recebe o valor efetivamente pago
+    protocol::Status pay(const std::string& nipc, double amount, double& paid, double& balance);
+    // Empréstimo a uma empresa cadastrada, com o plano de parcelas
+    protocol::Status addLoan(const std::string& nipc, double amount, int months, double& balance);
+    protocol::Status createTask(const std::string& nipc, const std::string& description);
+    protocol::Status getReport(double& totalLent, double& totalReceived, double& overallBalance);
+
+private:
+    // Envia o pedido e espera pela resposta; o corpo começa em payload[6]
+    protocol::Status call(protocol::FrameWriter& request, std::string& payload);
+    void disconnect();
+
+    int fd;
+    uint32_t nextId;
+    std::string buffer;
+};
+
+#endif // BANK_CLIENT_H
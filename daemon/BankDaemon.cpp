@@ -0,0 +1,546 @@
+#include "BankDaemon.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "BinaryProtocol.h"
+#include "batch_mode.h"
+#include "trace.h"
+
+namespace {
+
+// Intervalo com que o ciclo de I/O verifica se stop() foi chamado
+const int kPollMs = 200;
+// Uma conexão deixa de ser lida enquanto tiver estes pedidos por responder ou estas
+// respostas por enviar (um cliente que não lê não faz o servidor crescer sem limite)
+const size_t kMaxPendingRequests = 1024;
+const size_t kMaxPendingOutput = 4 * 1024 * 1024;
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+// Estado de uma conexão de cliente; só é usado pela thread de I/O
+struct BankDaemon::Connection {
+    enum class Protocol { Unknown, Text, Binary };
+
+    // Pedido lido mas ainda não entregue ao pool
+    struct Request {
+        bool write;
+        size_t lineNumber;
+        std::string data;
+    };
+
+    int fd;
+    Protocol protocol = Protocol::Unknown;
+    std::string input;
+    size_t lineNumber = 0;
+    std::deque<Request> waiting;
+    uint64_t nextSequence = 0;
+    uint64_t nextToSend = 0;
+    // Respostas que chegaram antes das de pedidos anteriores
+    std::map<uint64_t, std::string> finished;
+    size_t inFlight = 0;
+    bool writeInFlight = false;
+    std::string output;
+    bool inputClosed = false;
+    bool failed = false;
+
+    explicit Connection(int fd) : fd(fd) {}
+
+    bool canRead() const {
+        return !inputClosed && !failed && waiting.size() + inFlight < kMaxPendingRequests
+            && output.size() < kMaxPendingOutput;
+    }
+    bool done() const {
+        return failed || (inputClosed && waiting.empty() && inFlight == 0 && output.empty());
+    }
+};
+
+BankDaemon::BankDaemon(const std::string& dbPath, const std::string& socketPath, size_t workerCount)
+    : dbPath(dbPath), socketPath(socketPath), workerCount(workerCount == 0 ? 1 : workerCount),
+      listenFd(-1), wakePipe{-1, -1}, running(false) {}
+
+BankDaemon::~BankDaemon() {
+    shutdown();
+}
+
+bool BankDaemon::start() {
+    writer.reset(new DatabaseManager(dbPath));
+    if (!writer->isConnectedToDatabase() || !writer->enableConcurrentAccess()) {
+        std::cerr << "Erro ao abrir " << dbPath << " para escrita\n";
+        return false;
+    }
+    for (size_t i = 0; i < workerCount; i++) {
+        readers.emplace_back(new DatabaseManager(dbPath));
+        if (!readers.back()->isConnectedToDatabase() || !readers.back()->enableConcurrentAccess()) {
+            std::cerr << "Erro ao abrir " << dbPath << " para leitura\n";
+            return false;
+        }
+    }
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Caminho do socket demasiado longo: " << socketPath << "\n";
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    if (::pipe(wakePipe) < 0 || !setNonBlocking(wakePipe[0]) || !setNonBlocking(wakePipe[1])) {
+        std::cerr << "Erro ao criar pipe: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Erro ao criar socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    // Um socket deixado por uma execução anterior impede o bind
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(listenFd, SOMAXCONN) < 0) {
+        std::cerr << "Erro ao escutar em " << socketPath << ": " << std::strerror(errno) << "\n";
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    running = true;
+    for (size_t i = 0; i < workerCount; i++) {
+        DatabaseManager& reader = *readers[i];
+        workers.emplace_back([this, &reader]() { workerLoop(reader); });
+    }
+    return true;
+}
+
+void BankDaemon::run() {
+    std::vector<pollfd> fds;
+    while (running) {
+        // [0] pipe do pool, [1] socket de escuta, [2..] clientes pela ordem de connections
+        fds.clear();
+        fds.push_back({wakePipe[0], POLLIN, 0});
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const auto& connection : connections) {
+            short events = 0;
+            if (connection->canRead()) events |= POLLIN;
+            if (!connection->output.empty()) events |= POLLOUT;
+            // Sem eventos pedidos o fd fica de fora, para que um POLLHUP não acorde o ciclo
+            // enquanto a conexão espera pelo pool
+            fds.push_back({events != 0 ? connection->fd : -1, events, 0});
+        }
+
+        int ready = ::poll(fds.data(), fds.size(), kPollMs);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "Erro no poll: " << std::strerror(errno) << "\n";
+            break;
+        }
+        if (ready <= 0) continue;
+
+        // As conexões aceites agora só entram no poll seguinte
+        size_t polled = connections.size();
+        for (size_t i = 0; i < polled; i++) {
+            Connection& connection = *connections[i];
+            short revents = fds[i + 2].revents;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                readConnection(connection);
+                dispatch(connections[i]);
+            }
+            if (revents & POLLOUT) flushConnection(connection);
+        }
+        if (fds[0].revents & POLLIN) collectCompletions();
+        if (fds[1].revents & POLLIN) acceptConnections();
+
+        for (auto it = connections.begin(); it != connections.end();) {
+            if ((*it)->done()) {
+                closeConnection(**it);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    shutdown();
+}
+
+void BankDaemon::shutdown() {
+    running = false;
+    queueReady.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+    jobs.clear();
+    completions.clear();
+    for (auto& connection : connections) closeConnection(*connection);
+    connections.clear();
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+        listenFd = -1;
+    }
+    for (int& fd : wakePipe) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+}
+
+void BankDaemon::acceptConnections() {
+    while (true) {
+        int client = ::accept(listenFd, nullptr, nullptr);
+        if (client < 0) return;
+        if (!setNonBlocking(client)) {
+            ::close(client);
+            continue;
+        }
+        connections.push_back(std::make_shared<Connection>(client));
+    }
+}
+
+void BankDaemon::closeConnection(Connection& connection) {
+    if (connection.fd >= 0) ::close(connection.fd);
+    // Respostas que ainda cheguem do pool para esta conexão são descartadas
+    connection.fd = -1;
+    connection.failed = true;
+}
+
+void BankDaemon::readConnection(Connection& connection) {
+    char chunk[16384];
+    ssize_t n = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+    if (n < 0) {
+        if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) connection.failed = true;
+        return;
+    }
+    if (n == 0) {
+        // O cliente fechou a escrita; os pedidos já lidos ainda são respondidos
+        connection.inputClosed = true;
+        return;
+    }
+    connection.input.append(chunk, static_cast<size_t>(n));
+    parseRequests(connection);
+}
+
+// Separa as linhas ou frames completos de input em pedidos; o resto fica para a leitura seguinte
+void BankDaemon::parseRequests(Connection& connection) {
+    std::string& buffer = connection.input;
+    if (connection.protocol == Connection::Protocol::Unknown) {
+        size_t prefix = std::min(buffer.size(), sizeof(protocol::kMagic));
+        if (std::memcmp(buffer.data(), protocol::kMagic, prefix) == 0) {
+            if (prefix < sizeof(protocol::kMagic)) return;
+            connection.protocol = Connection::Protocol::Binary;
+            buffer.erase(0, sizeof(protocol::kMagic));
+        } else {
+            connection.protocol = Connection::Protocol::Text;
+        }
+    }
+
+    size_t start = 0;
+    if (connection.protocol == Connection::Protocol::Text) {
+        size_t end;
+        while ((end = buffer.find('\n', start)) != std::string::npos) {
+            std::string line = buffer.substr(start, end - start);
+            start = end + 1;
+            connection.lineNumber++;
+            // Linhas vazias e comentários não têm resposta
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            bool write = !isReadOnlyCommand(line);
+            connection.waiting.push_back({write, connection.lineNumber, std::move(line)});
+        }
+    } else {
+        std::string payload;
+        bool tooLarge = false;
+        while (protocol::nextFrame(buffer, start, payload, tooLarge)) {
+            bool write = payload.empty() || !protocol::isReadOnly(static_cast<protocol::Opcode>(payload[0]));
+            connection.waiting.push_back({write, 0, std::move(payload)});
+            payload.clear();
+        }
+        if (tooLarge) connection.failed = true;
+    }
+    buffer.erase(0, start);
+}
+
+// Entrega ao pool os pedidos que podem correr já: consultas enquanto não houver uma
+// escrita em curso, e uma escrita quando nada mais da conexão estiver em curso
+void BankDaemon::dispatch(const std::shared_ptr<Connection>& connection) {
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        while (!connection->failed && !connection->waiting.empty() && !connection->writeInFlight) {
+            Connection::Request& next = connection->waiting.front();
+            if (next.write && connection->inFlight > 0) break;
+            jobs.push_back({connection, connection->nextSequence++,
+                            connection->protocol == Connection::Protocol::Binary, next.lineNumber, std::move(next.data)});
+            connection->inFlight++;
+            connection->writeInFlight = next.write;
+            connection->waiting.pop_front();
+            added = true;
+        }
+    }
+    if (added) queueReady.notify_all();
+}
+
+// Recebe as respostas do pool, junta-as às saídas pela ordem dos pedidos e liberta os
+// pedidos que esperavam por elas
+void BankDaemon::collectCompletions() {
+    char drain[256];
+    while (::read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ready.swap(completions);
+    }
+    for (auto& completion : ready) {
+        Connection& connection = *completion.connection;
+        if (connection.fd < 0) continue;
+        connection.inFlight--;
+        if (connection.inFlight == 0) connection.writeInFlight = false;
+        connection.finished[completion.sequence] = std::move(completion.response);
+
+        auto next = connection.finished.begin();
+        while (next != connection.finished.end() && next->first == connection.nextToSend) {
+            connection.output += next->second;
+            connection.nextToSend++;
+            next = connection.finished.erase(next);
+        }
+        dispatch(completion.connection);
+        flushConnection(connection);
+    }
+}
+
+void BankDaemon::flushConnection(Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t n = ::send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            connection.failed = true;
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    connection.output.erase(0, sent);
+}
+
+void BankDaemon::workerLoop(DatabaseManager& reader) {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return !running || !jobs.empty(); });
+            if (!running) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        std::string response;
+        {
+            TRACE_SCOPE("daemonRequest");
+            response = job.binary ? handleFrame(job.request, reader) : handleLine(job.request, job.lineNumber, reader);
+        }
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back({std::move(job.connection), job.sequence, std::move(response)});
+        }
+        char wake = 0;
+        // Com o pipe cheio a thread de I/O já tem um aviso por ler
+        ssize_t ignored = ::write(wakePipe[1], &wake, 1);
+        (void)ignored;
+    }
+}
+
+std::string BankDaemon::handleLine(const std::string& line, size_t lineNumber, DatabaseManager& reader) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') return "";
+
+    CommandResult result;
+    if (isReadOnlyCommand(line)) {
+        result = executeCommand(reader, line);
+    } else {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        result = executeCommandAtomically(*writer, line);
+    }
+    return formatCommandResult(lineNumber, result) + "\n";
+}
+
+std::string BankDaemon::handleFrame(const std::string& payload, DatabaseManager& reader) {
+    protocol::FrameReader request(payload.data(), payload.size());
+    auto opcode = static_cast<protocol::Opcode>(request.u8());
+    uint32_t id = request.u32();
+
+    protocol::FrameWriter response;
+    if (opcode != protocol::Opcode::Batch) {
+        if (protocol::isReadOnly(opcode)) {
+            response.bytes(executeRequest(payload, reader));
+        } else {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            response.bytes(executeRequest(payload, *writer));
+        }
+        return response.finish();
+    }
+
+    response.u8(static_cast<uint8_t>(opcode));
+    response.u32(id);
+    uint32_t count = request.u32();
+    std::vector<std::string> items;
+    for (uint32_t i = 0; i < count && request.ok(); i++) {
+        uint32_t size = request.u32();
+        items.push_back(request.bytes(size));
+    }
+    if (!request.ok() || !request.atEnd()) {
+        response.u8(static_cast<uint8_t>(protocol::Status::BadRequest));
+        return response.finish();
+    }
+
+    std::vector<std::string> results;
+    results.reserve(items.size());
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        bool committed = writer->beginTransaction();
+        if (committed) {
+            for (const auto& item : items) results.push_back(executeRequest(item, *writer));
+            committed = writer->commitTransaction();
+            if (!committed) writer->rollbackTransaction();
+        }
+        if (!committed) {
+            // Nada do lote foi gravado: cada pedido responde Failed
+            results.clear();
+            for (const auto& item : items) {
+                protocol::FrameReader itemReader(item.data(), item.size());
+                protocol::FrameWriter failed;
+                failed.u8(itemReader.u8());
+                failed.u32(itemReader.u32());
+                failed.u8(static_cast<uint8_t>(protocol::Status::Failed));
+                results.push_back(failed.payload());
+            }
+        }
+    }
+
+    response.u8(static_cast<uint8_t>(protocol::Status::Ok));
+    response.u32(static_cast<uint32_t>(results.size()));
+    for (const auto& result : results) {
+        response.u32(static_cast<uint32_t>(result.size()));
+        response.bytes(result);
+    }
+    return response.finish();
+}
+
+// Executa um pedido simples e devolve o conteúdo da resposta (sem prefixo de tamanho)
+std::string BankDaemon::executeRequest(const std::string& payload, DatabaseManager& dbManager) {
+    protocol::FrameReader request(payload.data(), payload.size());
+    auto opcode = static_cast<protocol::Opcode>(request.u8());
+    uint32_t id = request.u32();
+
+    protocol::FrameWriter response;
+    response.u8(static_cast<uint8_t>(opcode));
+    response.u32(id);
+    auto reply = [&](protocol::Status status) { response.u8(static_cast<uint8_t>(status)); };
+
+    switch (opcode) {
+        case protocol::Opcode::GetCompany:
+        case protocol::Opcode::FindCompany: {
+            std::string key = request.str();
+            if (!request.ok()) {
+                reply(protocol::Status::BadRequest);
+                break;
+            }
+            Company company = opcode == protocol::Opcode::GetCompany ? dbManager.getCompany(key)
+                                                                     : dbManager.getCompanyByNipcOrName(key);
+            if (company.getName().empty()) {
+                reply(protocol::Status::NotFound);
+                break;
+            }
+            reply(protocol::Status::Ok);
+            response.str(company.getName());
+            response.str(company.getNIPC());
+            response.str(company.getLocation());
+            response.str(company.getEmployeeName());
+            response.f64(company.getLoanAmount());
+            response.f64(company.getBalance());
+            break;
+        }
+        case protocol::Opcode::UpdateCompanyBalance: {
+            std::string nipc = request.str();
+            double amount = request.f64();
+            // Mesmas regras do modo batch: só créditos com valor finito e positivo
+            if (!request.ok() || !isValidAmount(amount)) {
+                reply(protocol::Status::BadRequest);
+                break;
+            }
+            // updateCompanyBalance não falha com um NIPC sem empresa; a escrita é serializada,
+            // pelo que a empresa não desaparece entre a consulta e a atualização
+            if (dbManager.getCompany(nipc).getName().empty()) {
+                reply(protocol::Status::NotFound);
+                break;
+            }
+            reply(dbManager.updateCompanyBalance(nipc, amount) ? protocol::Status::Ok : protocol::Status::Failed);
+            break;
+        }
+        case protocol::Opcode::CreateTask: {
+            std::string nipc = request.str();
+            std::string description = request.str();
+            if (!request.ok()) {
+                reply(protocol::Status::BadRequest);
+                break;
+            }
+            reply(dbManager.createTask(Task(description, nipc)) ? protocol::Status::Ok : protocol::Status::Failed);
+            break;
+        }
+        case protocol::Opcode::Payment:
+        case protocol::Opcode::Loan: {
+            std::string nipc = request.str();
+            double amount = request.f64();
+            uint32_t months = opcode == protocol::Opcode::Loan ? request.u32() : 0;
+            if (!request.ok() || !isValidAmount(amount)
+                || (opcode == protocol::Opcode::Loan && (months < 1 || months > 360))) {
+                reply(protocol::Status::BadRequest);
+                break;
+            }
+            Company company = dbManager.getCompany(nipc);
+            if (company.getName().empty()) {
+                reply(protocol::Status::NotFound);
+                break;
+            }
+            if (opcode == protocol::Opcode::Payment && company.getBalance() >= 0) {
+                reply(protocol::Status::Rejected);
+                break;
+            }
+            // Um empréstimo com o plano de parcelas por gravar é desfeito por inteiro
+            const char* command = opcode == protocol::Opcode::Payment ? "pagamento" : "emprestimo";
+            CommandResult result = runAtomically(dbManager, command, [&]() {
+                return opcode == protocol::Opcode::Payment
+                    ? paymentCommand(dbManager, nipc, amount)
+                    : loanCommand(dbManager, nipc, amount, static_cast<int>(months));
+            });
+            if (!result.success) {
+                reply(protocol::Status::Failed);
+                break;
+            }
+            reply(protocol::Status::Ok);
+            if (opcode == protocol::Opcode::Payment) response.f64(result.amount);
+            response.f64(result.balance);
+            break;
+        }
+        case protocol::Opcode::GetReport:
+            reply(protocol::Status::Ok);
+            response.f64(dbManager.getTotalEmprestado());
+            response.f64(dbManager.getTotalRecebido());
+            response.f64(dbManager.getSaldoGeral());
+            break;
+        default:
+            // Inclui Batch dentro de Batch
+            reply(protocol::Status::BadRequest);
+    }
+    return response.payload();
+}
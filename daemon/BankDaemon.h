@@ -0,0 +1,100 @@
+#ifndef BANK_DAEMON_H
+#define BANK_DAEMON_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "database/DatabaseManager.h"
+
+// Servidor local que é dono do banco de dados e atende clientes por um socket Unix.
+//
+// Protocolos: conexões que começam com protocol::kMagic usam o protocolo binário
+// (BinaryProtocol.h); as restantes usam texto, um comando por linha com a gramática do modo batch (batch_mode.h);
+// para cada linha recebida o servidor devolve uma linha JSON, pela mesma ordem (linhas
+// vazias e comentários não têm resposta). Um cliente pode enviar várias linhas sem
+// esperar pelas respostas.
+//
+// Uma thread de I/O atende todas as conexões com poll: lê os pedidos (linhas ou frames)
+// e entrega cada um ao pool, que executa os pedidos de todas as conexões. Cada thread do
+// pool tem a sua própria conexão SQLite de leitura, pelo que as consultas correm em
+// paralelo; as escritas passam todas por uma única conexão de escrita, protegida por um
+// mutex. Numa conexão, consultas seguidas podem correr em simultâneo, mas uma escrita
+// espera pelos pedidos anteriores e os seguintes esperam por ela; as respostas são
+// enviadas pela ordem dos pedidos. Conexões inativas não ocupam threads do pool.
+class BankDaemon {
+public:
+    BankDaemon(const std::string& dbPath, const std::string& socketPath, size_t workerCount);
+    ~BankDaemon();
+
+    BankDaemon(const BankDaemon&) = delete;
+    BankDaemon& operator=(const BankDaemon&) = delete;
+
+    // Abre as conexões, cria o socket e inicia o pool
+    bool start();
+    // Atende as conexões até stop() ser chamado (pode ser chamado de um handler de sinal)
+    void run();
+    void stop() { running = false; }
+
+private:
+    struct Connection;
+
+    // Pedido entregue ao pool
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        uint64_t sequence;
+        bool binary;
+        size_t lineNumber;
+        std::string request;
+    };
+
+    // Resposta devolvida pelo pool à thread de I/O
+    struct Completion {
+        std::shared_ptr<Connection> connection;
+        uint64_t sequence;
+        std::string response;
+    };
+
+    void workerLoop(DatabaseManager& reader);
+    void acceptConnections();
+    void readConnection(Connection& connection);
+    void parseRequests(Connection& connection);
+    void dispatch(const std::shared_ptr<Connection>& connection);
+    void collectCompletions();
+    void flushConnection(Connection& connection);
+    void closeConnection(Connection& connection);
+    std::string handleLine(const std::string& line, size_t lineNumber, DatabaseManager& reader);
+    std::string handleFrame(const std::string& payload, DatabaseManager& reader);
+    std::string executeRequest(const std::string& payload, DatabaseManager& dbManager);
+    void shutdown();
+
+    std::string dbPath;
+    std::string socketPath;
+    size_t workerCount;
+    int listenFd;
+    // O pool acorda a thread de I/O escrevendo um byte neste pipe
+    int wakePipe[2];
+    std::atomic<bool> running;
+
+    std::unique_ptr<DatabaseManager> writer;
+    std::mutex writerMutex;
+    std::vector<std::unique_ptr<DatabaseManager>> readers;
+
+    // Só usadas pela thread de I/O
+    std::vector<std::shared_ptr<Connection>> connections;
+
+    std::deque<Job> jobs;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::vector<std::thread> workers;
+
+    std::vector<Completion> completions;
+    std::mutex completionMutex;
+};
+
+#endif // BANK_DAEMON_H
@@ -0,0 +1,96 @@
+#include "BinaryProtocol.h"
+#include <cstring>
+
+namespace protocol {
+
+void FrameWriter::u32(uint32_t value) {
+    for (int i = 0; i < 4; i++) data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void FrameWriter::f64(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; i++) data.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+}
+
+void FrameWriter::str(std::string_view value) {
+    size_t size = value.size() > 0xFFFF ? 0xFFFF : value.size();
+    data.push_back(static_cast<char>(size & 0xFF));
+    data.push_back(static_cast<char>(size >> 8));
+    data.append(value.data(), size);
+}
+
+std::string FrameWriter::finish() {
+    uint32_t size = static_cast<uint32_t>(data.size() - 4);
+    for (int i = 0; i < 4; i++) data[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+    return std::move(data);
+}
+
+bool FrameReader::take(size_t size) {
+    if (!valid || remaining < size) {
+        valid = false;
+        return false;
+    }
+    return true;
+}
+
+uint8_t FrameReader::u8() {
+    if (!take(1)) return 0;
+    uint8_t value = static_cast<uint8_t>(*cursor);
+    cursor++;
+    remaining--;
+    return value;
+}
+
+uint32_t FrameReader::u32() {
+    if (!take(4)) return 0;
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(static_cast<uint8_t>(cursor[i])) << (8 * i);
+    cursor += 4;
+    remaining -= 4;
+    return value;
+}
+
+double FrameReader::f64() {
+    if (!take(8)) return 0.0;
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) bits |= static_cast<uint64_t>(static_cast<uint8_t>(cursor[i])) << (8 * i);
+    cursor += 8;
+    remaining -= 8;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string FrameReader::str() {
+    if (!take(2)) return "";
+    size_t size = static_cast<uint8_t>(cursor[0]) | (static_cast<size_t>(static_cast<uint8_t>(cursor[1])) << 8);
+    cursor += 2;
+    remaining -= 2;
+    return bytes(size);
+}
+
+std::string FrameReader::bytes(size_t size) {
+    if (!take(size)) return "";
+    std::string value(cursor, size);
+    cursor += size;
+    remaining -= size;
+    return value;
+}
+
+bool nextFrame(const std::string& buffer, size_t& offset, std::string& payload, bool& tooLarge) {
+    tooLarge = false;
+    if (buffer.size() - offset < 4) return false;
+    FrameReader header(buffer.data() + offset, 4);
+    uint32_t size = header.u32();
+    if (size > kMaxFrameSize) {
+        tooLarge = true;
+        return false;
+    }
+    if (buffer.size() - offset - 4 < size) return false;
+    payload.assign(buffer, offset + 4, size);
+    offset += 4 + size;
+    return true;
+}
+
+} // namespace protocol
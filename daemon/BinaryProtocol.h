@@ -0,0 +1,111 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Protocolo binário do bank_daemon.
+//
+// O cliente envia primeiro os 4 bytes de kMagic; a partir daí a conexão troca frames
+// com um prefixo de 4 bytes com o tamanho do conteúdo. Inteiros e doubles são
+// little-endian; strings têm um prefixo de 2 bytes com o tamanho.
+//
+//   pedido:   u8 opcode | u32 id | corpo
+//   resposta: u8 opcode | u32 id | u8 status | corpo
+//
+// O id é escolhido pelo cliente e devolvido na resposta, o que permite enviar vários
+// pedidos sem esperar (pipelining). As respostas de uma conexão chegam pela ordem dos
+// pedidos. Corpos:
+//
+//   GetCompany            pedido: str nipc
+//                         resposta: str nome | str nipc | str local | str funcionário
+//                                   | f64 empréstimo | f64 saldo
+//   UpdateCompanyBalance  pedido: str nipc | f64 valor (crédito, finito e > 0; senão BadRequest;
+//                         NotFound se a empresa não existir)
+//   CreateTask            pedido: str nipc | str descrição
+//   GetReport             resposta: f64 total emprestado | f64 total recebido | f64 saldo geral
+//   FindCompany           pedido: str NIPC ou nome; resposta: como GetCompany
+//   Payment               pedido: str nipc | f64 valor (limitado à dívida, como no modo batch;
+//                         Rejected se a empresa não tiver dívida)
+//                         resposta: f64 valor pago | f64 saldo
+//   Loan                  pedido: str nipc | f64 valor | u32 parcelas (1 a 360)
+//                         resposta: f64 saldo
+//   Batch                 pedido: u32 n | n × (u32 tamanho | pedido)
+//                         resposta: u32 n | n × (u32 tamanho | resposta)
+//
+// Um Batch é executado numa única transação na conexão de escrita; se o commit falhar,
+// todos os pedidos do lote respondem Failed.
+namespace protocol {
+
+const char kMagic[4] = {'B', 'N', 'K', '1'};
+const uint32_t kMaxFrameSize = 16 * 1024 * 1024;
+
+enum class Opcode : uint8_t {
+    GetCompany = 1,
+    UpdateCompanyBalance = 2,
+    CreateTask = 3,
+    GetReport = 4,
+    Batch = 5,
+    FindCompany = 6,
+    Payment = 7,
+    Loan = 8
+};
+
+enum class Status : uint8_t {
+    Ok = 0,
+    NotFound = 1,
+    Failed = 2,
+    BadRequest = 3,
+    Rejected = 4
+};
+
+// Pedidos que só leem e correm nas conexões de leitura do servidor
+inline bool isReadOnly(Opcode opcode) {
+    return opcode == Opcode::GetCompany || opcode == Opcode::GetReport || opcode == Opcode::FindCompany;
+}
+
+// Constrói um frame; o prefixo de tamanho é preenchido por finish()
+class FrameWriter {
+public:
+    FrameWriter() : data(4, '\0') {}
+    void u8(uint8_t value) { data.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value);
+    void f64(double value);
+    void str(std::string_view value);
+    void bytes(const std::string& value) { data += value; }
+    // Conteúdo sem o prefixo (para frames dentro de um Batch)
+    std::string payload() const { return data.substr(4); }
+    std::string finish();
+
+private:
+    std::string data;
+};
+
+// Lê campos de um conteúdo; depois de um erro de leitura, ok() fica falso e
+// os campos seguintes devolvem zero ou vazio
+class FrameReader {
+public:
+    FrameReader(const char* data, size_t size) : cursor(data), remaining(size), valid(true) {}
+    uint8_t u8();
+    uint32_t u32();
+    double f64();
+    std::string str();
+    std::string bytes(size_t size);
+    bool ok() const { return valid; }
+    bool atEnd() const { return remaining == 0; }
+
+private:
+    bool take(size_t size);
+    const char* cursor;
+    size_t remaining;
+    bool valid;
+};
+
+// Se buffer[offset..] contém um frame completo, devolve em payload o seu conteúdo e
+// avança offset. Devolve false se faltam bytes; tooLarge indica um prefixo inválido.
+bool nextFrame(const std::string& buffer, size_t& offset, std::string& payload, bool& tooLarge);
+
+} // namespace protocol
+
+#endif // BINARY_PROTOCOL_H
@@ -0,0 +1,113 @@
+/**
+ * @file bank_client.cpp
+ * @brief Cliente do bank_daemon para a linha de comandos
+ * @details Envia comandos com a gramática do modo batch e escreve as respostas JSON.
+ *          Uso: bank_client [--socket database/bank.sock] [comando ...]
+ *          Sem comandos nos argumentos, lê um comando por linha da entrada padrão.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+int connectTo(const std::string& socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return -1;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = "database/bank.sock";
+    std::vector<std::string> commands;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else {
+            commands.push_back(arg);
+        }
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        std::cerr << "Não foi possível ligar a " << socketPath << " (o bank_daemon está em execução?)\n";
+        return 1;
+    }
+
+    // O envio corre numa thread à parte: com muitos comandos, o servidor só continua
+    // a ler depois de as suas respostas serem consumidas
+    std::atomic<bool> sendFailed(false);
+    std::thread sender([&]() {
+        std::string buffer;
+        auto flush = [&]() {
+            if (!sendAll(fd, buffer)) sendFailed = true;
+            buffer.clear();
+        };
+        if (!commands.empty()) {
+            for (const auto& command : commands) buffer += command + "\n";
+        } else {
+            std::ios::sync_with_stdio(false);
+            std::string line;
+            while (!sendFailed && std::getline(std::cin, line)) {
+                buffer += line;
+                buffer += '\n';
+                if (buffer.size() >= 16384) flush();
+            }
+        }
+        flush();
+        ::shutdown(fd, SHUT_WR);
+    });
+
+    char chunk[16384];
+    ssize_t n;
+    while ((n = ::recv(fd, chunk, sizeof(chunk), 0)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        std::cout.write(chunk, n);
+    }
+    sender.join();
+    ::close(fd);
+    std::cout.flush();
+
+    if (sendFailed) {
+        std::cerr << "A ligação ao servidor foi interrompida.\n";
+        return 1;
+    }
+    return 0;
+}
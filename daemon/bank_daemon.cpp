@@ -0,0 +1,89 @@
+/**
+ * @file bank_daemon.cpp
+ * @brief Servidor local do banco de dados, atendido por um socket Unix
+ * @details Uso: bank_daemon [--database database/bank.db] [--socket database/bank.sock]
+ *                           [--workers N] [--profile teller]
+ *          O perfil memory é recusado: cada conexão teria a sua cópia do banco.
+ *          Termina com SIGINT/SIGTERM, removendo o socket.
+ */
+
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "BankDaemon.h"
+#include "database/ActivityLog.h"
+#include "database/QueryStats.h"
+#include "trace.h"
+
+namespace {
+    BankDaemon* activeDaemon = nullptr;
+
+    void handleSignal(int) {
+        if (activeDaemon) activeDaemon->stop();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string dbPath = "database/bank.db";
+    std::string socketPath = "database/bank.sock";
+    size_t workers = std::thread::hardware_concurrency();
+    DatabaseOptions options;
+    databaseProfile("teller", options);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << arg << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--database") {
+            dbPath = value;
+        } else if (arg == "--socket") {
+            socketPath = value;
+        } else if (arg == "--workers") {
+            workers = static_cast<size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--profile") {
+            if (!databaseProfile(value, options)) {
+                std::cerr << "Perfil desconhecido: " << value << " (" << databaseProfileNames() << ")\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Opção desconhecida: " << arg << "\n";
+            return 1;
+        }
+    }
+    // Cada conexão do daemon teria a sua cópia privada do banco em memória: as consultas
+    // não veriam as escritas, e nada seria gravado no arquivo
+    if (options.inMemory) {
+        std::cerr << "O perfil " << options.profile << " (banco em memória) não é suportado pelo bank_daemon\n";
+        return 1;
+    }
+    if (workers == 0) workers = 4;
+    setDefaultDatabaseOptions(options);
+    // O registo de atividades fica ao lado do banco
+    ActivityLog::instance().open((std::filesystem::path(dbPath).parent_path() / "activity.log").string());
+
+    BankDaemon daemon(dbPath, socketPath, workers);
+    if (!daemon.start()) return 1;
+
+    activeDaemon = &daemon;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    // Um cliente que fecha a conexão antes de ler as respostas não deve derrubar o servidor
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "bank_daemon a escutar em " << socketPath << " com " << workers << " threads, perfil "
+              << QueryStats::instance().databaseSettings() << "\n";
+    daemon.run();
+    activeDaemon = nullptr;
+
+    QueryStats::instance().writeJson("database/query_stats.json");
+    TRACE_DUMP("database/trace.json");
+    ActivityLog::instance().close();
+    std::cerr << "bank_daemon terminado\n";
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file bank_loadgen.cpp
+ * @brief Gerador de carga para o protocolo binário do bank_daemon
+ * @details Envia uma mistura de consultas (getCompany) e depósitos (updateCompanyBalance)
+ *          sobre uma carteira gerada pelo generate_portfolio, mantendo até --pipeline
+ *          frames em trânsito. Com --batch B, os depósitos seguem em frames Batch de B
+ *          pedidos (uma transação cada). No fim mostra pedidos/s e latência por frame.
+ *
+ *          Uso: bank_loadgen [--socket database/bank.sock] [--requests 100000]
+ *                            [--pipeline 32] [--batch 0] [--read-share 0.8]
+ *                            [--companies 10000] [--seed 42]
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "BinaryProtocol.h"
+#include "tools/PortfolioGenerator.h"
+
+namespace {
+
+struct LoadOptions {
+    std::string socketPath = "database/bank.sock";
+    long long requests = 100000;
+    size_t pipeline = 32;
+    size_t batch = 0;
+    double readShare = 0.8;
+    long long companies = 10000;
+    unsigned long long seed = 42;
+};
+
+struct LoadStats {
+    long long requests = 0;
+    long long frames = 0;
+    long long ok = 0;
+    long long notFound = 0;
+    long long failed = 0;
+    std::vector<double> frameLatencyUs;
+};
+
+int connectTo(const std::string& socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return -1;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void countStatus(uint8_t status, LoadStats& stats) {
+    switch (static_cast<protocol::Status>(status)) {
+        case protocol::Status::Ok: stats.ok++; break;
+        case protocol::Status::NotFound: stats.notFound++; break;
+        default: stats.failed++;
+    }
+}
+
+// Lê a resposta de um frame e contabiliza o estado de cada pedido que ele contém
+bool readResponse(const std::string& payload, LoadStats& stats) {
+    protocol::FrameReader response(payload.data(), payload.size());
+    auto opcode = static_cast<protocol::Opcode>(response.u8());
+    response.u32();
+    uint8_t status = response.u8();
+    if (opcode != protocol::Opcode::Batch || status != static_cast<uint8_t>(protocol::Status::Ok)) {
+        countStatus(status, stats);
+        stats.requests++;
+        return response.ok();
+    }
+    uint32_t count = response.u32();
+    for (uint32_t i = 0; i < count && response.ok(); i++) {
+        std::string item = response.bytes(response.u32());
+        protocol::FrameReader itemReader(item.data(), item.size());
+        itemReader.u8();
+        itemReader.u32();
+        countStatus(itemReader.u8(), stats);
+        stats.requests++;
+    }
+    return response.ok();
+}
+
+bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (arg == "--socket") {
+            options.socketPath = value;
+        } else if (arg == "--requests") {
+            options.requests = std::atoll(value.c_str());
+        } else if (arg == "--pipeline") {
+            options.pipeline = static_cast<size_t>(std::atoll(value.c_str()));
+        } else if (arg == "--batch") {
+            options.batch = static_cast<size_t>(std::atoll(value.c_str()));
+        } else if (arg == "--read-share") {
+            options.readShare = std::atof(value.c_str());
+        } else if (arg == "--companies") {
+            options.companies = std::atoll(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return options.requests > 0 && options.pipeline > 0 && options.companies > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Uso: bank_loadgen [--socket caminho] [--requests N] [--pipeline D] [--batch B]\n"
+                     "                    [--read-share 0.8] [--companies N] [--seed S]\n";
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    int fd = connectTo(options.socketPath);
+    if (fd < 0 || !sendAll(fd, std::string(protocol::kMagic, sizeof(protocol::kMagic)))) {
+        std::cerr << "Não foi possível ligar a " << options.socketPath << "\n";
+        return 1;
+    }
+
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    uint32_t nextId = 1;
+
+    // Pedido simples (sem prefixo de tamanho), aleatório segundo a mistura pedida
+    auto makeRequest = [&](bool read) {
+        protocol::FrameWriter request;
+        request.u8(static_cast<uint8_t>(read ? protocol::Opcode::GetCompany : protocol::Opcode::UpdateCompanyBalance));
+        request.u32(nextId++);
+        request.str(portfolioNipc(static_cast<long long>(rng() % static_cast<unsigned long long>(options.companies))));
+        if (!read) request.f64(1.0);
+        return request.payload();
+    };
+
+    LoadStats stats;
+    stats.frameLatencyUs.reserve(static_cast<size_t>(options.requests));
+    std::deque<std::chrono::steady_clock::time_point> inFlight;
+    std::string receiveBuffer;
+    std::string payload;
+    char chunk[65536];
+    long long queued = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (queued < options.requests || !inFlight.empty()) {
+        std::string outgoing;
+        while (queued < options.requests && inFlight.size() < options.pipeline) {
+            bool read = coin(rng) < options.readShare;
+            protocol::FrameWriter frame;
+            if (!read && options.batch > 0) {
+                size_t count = static_cast<size_t>(std::min<long long>(options.batch, options.requests - queued));
+                frame.u8(static_cast<uint8_t>(protocol::Opcode::Batch));
+                frame.u32(nextId++);
+                frame.u32(static_cast<uint32_t>(count));
+                for (size_t i = 0; i < count; i++) {
+                    std::string item = makeRequest(false);
+                    frame.u32(static_cast<uint32_t>(item.size()));
+                    frame.bytes(item);
+                }
+                queued += static_cast<long long>(count);
+            } else {
+                frame.bytes(makeRequest(read));
+                queued++;
+            }
+            outgoing += frame.finish();
+            inFlight.push_back(std::chrono::steady_clock::now());
+        }
+        if (!outgoing.empty() && !sendAll(fd, outgoing)) {
+            std::cerr << "A ligação ao servidor foi interrompida.\n";
+            return 1;
+        }
+
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            std::cerr << "O servidor fechou a ligação.\n";
+            return 1;
+        }
+        receiveBuffer.append(chunk, static_cast<size_t>(n));
+
+        size_t offset = 0;
+        bool tooLarge = false;
+        while (protocol::nextFrame(receiveBuffer, offset, payload, tooLarge)) {
+            // As respostas chegam pela ordem dos pedidos
+            auto now = std::chrono::steady_clock::now();
+            stats.frameLatencyUs.push_back(std::chrono::duration<double, std::micro>(now - inFlight.front()).count());
+            inFlight.pop_front();
+            stats.frames++;
+            if (!readResponse(payload, stats)) {
+                std::cerr << "Resposta inválida do servidor.\n";
+                return 1;
+            }
+        }
+        receiveBuffer.erase(0, offset);
+        if (tooLarge) {
+            std::cerr << "Resposta inválida do servidor.\n";
+            return 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ::close(fd);
+
+    std::sort(stats.frameLatencyUs.begin(), stats.frameLatencyUs.end());
+    auto percentile = [&](double p) {
+        size_t index = static_cast<size_t>(p / 100.0 * (stats.frameLatencyUs.size() - 1));
+        return stats.frameLatencyUs[index];
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << stats.requests << " pedidos em " << stats.frames << " frames, " << std::setprecision(3)
+              << seconds << " s (" << std::setprecision(0) << stats.requests / seconds << " pedidos/s)\n";
+    std::cout << "ok " << stats.ok << ", não encontrados " << stats.notFound << ", falhas " << stats.failed << "\n";
+    std::cout << std::setprecision(1) << "latência por frame: p50 " << percentile(50) << " µs, p99 "
+              << percentile(99) << " µs, máx " << stats.frameLatencyUs.back() << " µs\n";
+    return stats.failed == 0 ? 0 : 1;
+}
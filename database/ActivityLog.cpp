@@ -0,0 +1,241 @@
+#include "ActivityLog.h"
+#include "../models/Nipc.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Intervalo entre lotes e entre fsyncs da thread de gravação
+const std::chrono::milliseconds kFlushInterval(10);
+const std::chrono::milliseconds kSyncInterval(1000);
+const size_t kBatchRecords = 1024;
+
+const char* kTypeNames[] = {
+    nullptr,
+    "empresa_criada",
+    "empresa_removida",
+    "movimento",
+    "emprestimo",
+    "plano_parcelas",
+    "juros",
+    "cobranca",
+    "tarefa_criada",
+    "tarefa_estado",
+    "tarefa_removida",
+    "perdidos",
+};
+const uint16_t kTypeCount = sizeof(kTypeNames) / sizeof(kTypeNames[0]);
+
+int64_t nowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint32_t currentProcessId() {
+#ifdef _WIN32
+    return static_cast<uint32_t>(_getpid());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+bool syncFile(std::FILE* file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+} // namespace
+
+const char* activityTypeName(uint16_t type) {
+    return type > 0 && type < kTypeCount ? kTypeNames[type] : nullptr;
+}
+
+bool activityTypeFromName(const std::string& name, uint16_t& type) {
+    for (uint16_t i = 1; i < kTypeCount; i++) {
+        if (name == kTypeNames[i]) {
+            type = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+ActivityLog& ActivityLog::instance() {
+    static ActivityLog log;
+    return log;
+}
+
+ActivityLog::~ActivityLog() {
+    close();
+}
+
+bool ActivityLog::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (running.load()) return true;
+
+    // Só se acrescentam registos a um arquivo vazio ou com o cabeçalho desta versão
+    ActivityLogHeader header = {};
+    bool empty = true;
+    if (std::FILE* existing = std::fopen(path.c_str(), "rb")) {
+        size_t bytes = std::fread(&header, 1, sizeof(header), existing);
+        std::fclose(existing);
+        empty = bytes == 0;
+        if (!empty && (bytes != sizeof(header) || std::memcmp(header.magic, kActivityLogMagic, sizeof(header.magic)) != 0
+                       || header.recordSize != sizeof(ActivityRecord))) {
+            std::cerr << "Registo de atividades com formato desconhecido: " << path << std::endl;
+            return false;
+        }
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cerr << "Erro ao abrir o registo de atividades: " << path << std::endl;
+        return false;
+    }
+    // Sem buffer do stdio: cada lote é uma única escrita no fim do arquivo (modo append), pelo
+    // que os registos de processos diferentes não se misturam
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    if (empty) {
+        std::memcpy(header.magic, kActivityLogMagic, sizeof(header.magic));
+        header.version = kActivityLogVersion;
+        header.recordSize = sizeof(ActivityRecord);
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+            std::cerr << "Erro ao gravar o registo de atividades: " << path << std::endl;
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+    }
+
+    if (!slots) {
+        slots.reset(new Slot[kCapacity]);
+        for (size_t i = 0; i < kCapacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    processId = currentProcessId();
+    stopFlusher = false;
+    running.store(true);
+    flusher = std::thread(&ActivityLog::flushLoop, this);
+    return true;
+}
+
+void ActivityLog::close() {
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (!running.load()) return;
+    running.store(false);
+    // Um record() que viu running antes da linha acima ainda pode estar a escrever no anel
+    while (producers.load() != 0) std::this_thread::yield();
+    {
+        std::lock_guard<std::mutex> flusherLock(flusherMutex);
+        stopFlusher = true;
+    }
+    flusherWake.notify_one();
+    flusher.join();
+
+    drain();
+    syncFile(file);
+    std::fclose(file);
+    file = nullptr;
+}
+
+void ActivityLog::record(ActivityType type, int64_t nipc, double amount, int64_t reference, uint16_t flags) {
+    if (!running.load(std::memory_order_relaxed)) return;
+    // Conta-se como produtor antes de voltar a ver running: ou close() espera por este
+    // registo, ou o registo vê o log fechado
+    producers.fetch_add(1);
+    if (running.load()) push(type, nipc, amount, reference, flags);
+    producers.fetch_sub(1, std::memory_order_release);
+}
+
+void ActivityLog::push(ActivityType type, int64_t nipc, double amount, int64_t reference, uint16_t flags) {
+    // Reserva uma posição livre; com o anel cheio o registo é perdido em vez de esperar
+    uint64_t position = head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[position & (kCapacity - 1)];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence - position);
+        if (difference == 0) {
+            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            droppedPending.fetch_add(1, std::memory_order_relaxed);
+            droppedTotal.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = {nowMicroseconds(), nipc, reference, amount, static_cast<uint16_t>(type), flags, processId};
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void ActivityLog::record(ActivityType type, const std::string& nipc, double amount, int64_t reference, uint16_t flags) {
+    if (!running.load(std::memory_order_relaxed)) return;
+    long long value;
+    record(type, parseNipc(nipc, value) ? value : 0, amount, reference, flags);
+}
+
+bool ActivityLog::pop(ActivityRecord& record) {
+    Slot& slot = slots[tail & (kCapacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+    record = slot.record;
+    slot.sequence.store(tail + kCapacity, std::memory_order_release);
+    tail++;
+    return true;
+}
+
+size_t ActivityLog::drain() {
+    static bool reportedError = false;
+    ActivityRecord batch[kBatchRecords];
+    size_t total = 0;
+    while (true) {
+        size_t count = 0;
+        // Os registos perdidos ficam assinalados no arquivo, no ponto em que se perderam
+        uint64_t lost = droppedPending.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            batch[count++] = {nowMicroseconds(), 0, static_cast<int64_t>(lost), 0.0,
+                              static_cast<uint16_t>(ActivityType::RecordsDropped), 0, processId};
+        }
+        while (count < kBatchRecords && pop(batch[count])) count++;
+        if (count == 0) break;
+
+        if (std::fwrite(batch, sizeof(ActivityRecord), count, file) != count && !reportedError) {
+            std::cerr << "Erro ao gravar o registo de atividades" << std::endl;
+            reportedError = true;
+        }
+        writtenCount.fetch_add(count, std::memory_order_relaxed);
+        total += count;
+        if (count < kBatchRecords) break;
+    }
+    return total;
+}
+
+void ActivityLog::flushLoop() {
+    auto lastSync = std::chrono::steady_clock::now();
+    bool unsynced = false;
+    std::unique_lock<std::mutex> lock(flusherMutex);
+    while (!stopFlusher) {
+        flusherWake.wait_for(lock, kFlushInterval);
+        lock.unlock();
+        if (drain() > 0) unsynced = true;
+        auto now = std::chrono::steady_clock::now();
+        if (unsynced && now - lastSync >= kSyncInterval) {
+            syncFile(file);
+            unsynced = false;
+            lastSync = now;
+        }
+        lock.lock();
+    }
+}
@@ -1,15 +1,256 @@
 #include "DatabaseManager.h"
+#include "ActivityLog.h"
+#include "QueryStats.h"
+#include "../models/Nipc.h"
+#include "../probe.h"
+#include <algorithm>
 #include <iostream>
-#include <fstream>
+#include <cstdlib>
 #include <cstring>
+#include <chrono>
 
-DatabaseManager::DatabaseManager(const std::string& path) : dbPath(path), db(nullptr), isConnected(false) {
+// Versão do esquema gravada em PRAGMA user_version. Deve ser incrementada sempre que
+// createTables ou as migrações mudarem, para que bancos existentes sejam atualizados.
+static const int kSchemaVersion = 3;
+
+// Colunas das tabelas companies e tasks, partilhadas por createTables e pela migração que
+// recria as tabelas. O NIPC é um inteiro de nove dígitos (o dígito de controlo é validado
+// pela aplicação, não pelo banco, para aceitar os NIPCs gravados antes dessa validação).
+static const char* kCompanyColumns =
+    "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "name TEXT NOT NULL,"
+    "nipc INTEGER NOT NULL UNIQUE CHECK (nipc BETWEEN 100000000 AND 999999999),"
+    "location TEXT NOT NULL,"
+    "employee_name TEXT NOT NULL,"
+    "loan_amount REAL NOT NULL,"
+    "loan_approved INTEGER NOT NULL DEFAULT 1,"
+    "balance REAL DEFAULT 0.0,"
+    "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+    "deleted INTEGER NOT NULL DEFAULT 0,"
+    "interest_rate REAL NOT NULL DEFAULT 0.08";
+
+static const char* kTaskColumns =
+    "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "description TEXT NOT NULL,"
+    "completed INTEGER NOT NULL DEFAULT 0,"
+    "company_id INTEGER NOT NULL,"
+    "created_at INTEGER NOT NULL,"
+    "completed_at INTEGER,"
+    "FOREIGN KEY (company_id) REFERENCES companies(id)";
+
+// Liga um NIPC em texto como inteiro. Um texto que não é NIPC fica NULL, que não
+// corresponde a nenhuma empresa.
+static void bindNipc(sqlite3_stmt* stmt, int index, std::string_view text) {
+    long long value;
+    if (parseNipc(text, value)) {
+        sqlite3_bind_int64(stmt, index, value);
+    } else {
+        sqlite3_bind_null(stmt, index);
+    }
+}
+
+// NIPC de uma coluna INTEGER, formatado em buffer (kNipcDigits caracteres)
+static std::string_view columnNipc(sqlite3_stmt* stmt, int column, char* buffer) {
+    formatNipc(sqlite3_column_int64(stmt, column), buffer);
+    return std::string_view(buffer, kNipcDigits);
+}
+
+DatabaseManager::DatabaseManager(const std::string& path)
+    : DatabaseManager(path, defaultDatabaseOptions()) {}
+
+DatabaseManager::DatabaseManager(const std::string& path, const DatabaseOptions& options)
+    : db(nullptr), isConnected(false), dbPath(path), schemaInitialized(false), options(options),
+      stopPersisting(false), busyLimitMs(0) {
+    QueryTimer timer(QueryOp::OpenDatabase);
     initializeDatabase();
+    if (isConnected && options.inMemory && options.persistIntervalSeconds > 0) {
+        persistThread = std::thread(&DatabaseManager::persistLoop, this);
+    }
+}
+
+// Handler de SQLITE_BUSY: como o sqlite3_busy_timeout, volta a tentar com esperas
+// crescentes até ao limite, mas conta cada nova tentativa nas estatísticas
+static int busyWait(void* context, int attempt) {
+    static const int kDelaysMs[] = {1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100};
+    static const int kDelayCount = sizeof(kDelaysMs) / sizeof(kDelaysMs[0]);
+    int timeoutMs = *static_cast<int*>(context);
+    int waitedMs = 0;
+    for (int i = 0; i < attempt; i++) {
+        waitedMs += kDelaysMs[i < kDelayCount ? i : kDelayCount - 1];
+    }
+    if (waitedMs >= timeoutMs) return 0;
+    int delayMs = std::min(kDelaysMs[attempt < kDelayCount ? attempt : kDelayCount - 1], timeoutMs - waitedMs);
+    QueryStats::instance().recordBusyRetry();
+    sqlite3_sleep(delayMs);
+    return 1;
+}
+
+void DatabaseManager::setBusyTimeout(int milliseconds) {
+    busyLimitMs = milliseconds;
+    sqlite3_busy_handler(db, milliseconds > 0 ? busyWait : nullptr, &busyLimitMs);
+}
+
+// Copia o banco inteiro de uma conexão para outra
+static bool copyDatabase(sqlite3* from, sqlite3* to) {
+    sqlite3_backup* backup = sqlite3_backup_init(to, "main", from, "main");
+    if (!backup) {
+        std::cerr << "Erro ao copiar banco de dados: " << sqlite3_errmsg(to) << std::endl;
+        return false;
+    }
+    int rc = sqlite3_backup_step(backup, -1);
+    sqlite3_backup_finish(backup);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Erro ao copiar banco de dados: " << sqlite3_errstr(rc) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// URI de uma conexão só de leitura; '?', '#' e '%' no caminho têm de ser codificados
+static std::string readOnlyUri(const std::string& path, bool immutable) {
+    std::string uri = "file:";
+    for (char c : path) {
+        if (c == '?') uri += "%3f";
+        else if (c == '#') uri += "%23";
+        else if (c == '%') uri += "%25";
+        else uri += c;
+    }
+    uri += "?mode=ro";
+    if (immutable) uri += "&immutable=1";
+    return uri;
+}
+
+// Modo em memória: começa com uma cópia do arquivo, se existir
+bool DatabaseManager::loadFromDisk() {
+    sqlite3* disk = nullptr;
+    int rc = sqlite3_open_v2(readOnlyUri(dbPath, false).c_str(), &disk, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, nullptr);
+    if (rc == SQLITE_CANTOPEN) {
+        sqlite3_close(disk);
+        return true;
+    }
+    bool success = rc == SQLITE_OK;
+    if (success) {
+        sqlite3_busy_timeout(disk, 5000);
+        success = copyDatabase(disk, db);
+    } else {
+        std::cerr << "Erro ao abrir " << dbPath << ": " << sqlite3_errmsg(disk) << std::endl;
+    }
+    sqlite3_close(disk);
+    return success;
+}
+
+bool DatabaseManager::persist() {
+    return persistTo(dbPath);
+}
+
+bool DatabaseManager::persistTo(const std::string& path) {
+    if (!isConnected || !options.inMemory) return false;
+    // O mutex da conexão impede que outra thread use o banco durante a cópia
+    sqlite3_mutex_enter(sqlite3_db_mutex(db));
+    bool success = false;
+    if (!sqlite3_get_autocommit(db)) {
+        std::cerr << "Transação em curso; o banco em memória não foi gravado" << std::endl;
+    } else {
+        success = copyToDisk(path);
+    }
+    sqlite3_mutex_leave(sqlite3_db_mutex(db));
+    return success;
+}
+
+// Chamada com o mutex da conexão e fora de transações
+bool DatabaseManager::copyToDisk(const std::string& path) {
+    QueryTimer timer(QueryOp::PersistDatabase);
+    sqlite3* disk = nullptr;
+    bool success = sqlite3_open(path.c_str(), &disk) == SQLITE_OK;
+    if (success) {
+        sqlite3_busy_timeout(disk, 5000);
+        success = copyDatabase(db, disk);
+    } else {
+        std::cerr << "Erro ao abrir " << path << ": " << sqlite3_errmsg(disk) << std::endl;
+    }
+    sqlite3_close(disk);
+    return success;
+}
+
+// Grava o banco em memória a cada persistIntervalSeconds; um intervalo que apanhe uma
+// transação em curso é saltado
+void DatabaseManager::persistLoop() {
+    std::unique_lock<std::mutex> lock(persistMutex);
+    while (!persistWake.wait_for(lock, std::chrono::seconds(options.persistIntervalSeconds),
+                                 [this]() { return stopPersisting; })) {
+        sqlite3_mutex_enter(sqlite3_db_mutex(db));
+        if (sqlite3_get_autocommit(db)) {
+            copyToDisk(dbPath);
+        }
+        sqlite3_mutex_leave(sqlite3_db_mutex(db));
+    }
+}
+
+// Aplica os pragmas do perfil. Os que não persistem no arquivo valem só para esta conexão,
+// pelo que são repetidos em cada abertura.
+bool DatabaseManager::applyOptions() {
+    if (options.busyTimeoutMs > 0) {
+        setBusyTimeout(options.busyTimeoutMs);
+    }
+    std::string sql;
+    // O journal_mode é gravado no arquivo; uma conexão só de leitura usa o que lá estiver
+    if (!options.journalMode.empty() && !options.readOnly) sql += "PRAGMA journal_mode = " + options.journalMode + ";";
+    if (!options.synchronous.empty()) sql += "PRAGMA synchronous = " + options.synchronous + ";";
+    if (options.cacheSizeKiB > 0) sql += "PRAGMA cache_size = -" + std::to_string(options.cacheSizeKiB) + ";";
+    if (options.mmapSizeBytes > 0) sql += "PRAGMA mmap_size = " + std::to_string(options.mmapSizeBytes) + ";";
+    if (!options.tempStore.empty()) sql += "PRAGMA temp_store = " + options.tempStore + ";";
+    if (options.walAutocheckpointPages > 0) {
+        sql += "PRAGMA wal_autocheckpoint = " + std::to_string(options.walAutocheckpointPages) + ";";
+    }
+    if (!sql.empty() && !executeSql(sql.c_str())) {
+        std::cerr << "Erro ao aplicar o perfil " << options.profile << std::endl;
+        return false;
+    }
+
+    // Valores em vigor (o SQLite pode recusar um modo, por exemplo WAL num banco em memória)
+    auto pragma = [this](const char* name) {
+        std::string value;
+        sqlite3_stmt* stmt;
+        std::string query = std::string("PRAGMA ") + name + ";";
+        if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            if (text) value = text;
+        }
+        sqlite3_finalize(stmt);
+        return value;
+    };
+    static const char* kSynchronousNames[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    static const char* kTempStoreNames[] = {"DEFAULT", "FILE", "MEMORY"};
+    int synchronous = std::atoi(pragma("synchronous").c_str());
+    int tempStore = std::atoi(pragma("temp_store").c_str());
+    long long cacheSize = std::atoll(pragma("cache_size").c_str());
+    std::string cache = cacheSize < 0 ? std::to_string(-cacheSize) + " KiB" : std::to_string(cacheSize) + " páginas";
+    settings = options.profile + " (journal_mode=" + pragma("journal_mode")
+        + ", synchronous=" + (synchronous >= 0 && synchronous <= 3 ? kSynchronousNames[synchronous] : "?")
+        + ", cache_size=" + cache
+        + ", mmap_size=" + std::to_string(std::atoll(pragma("mmap_size").c_str()) / (1024 * 1024)) + " MiB"
+        + ", temp_store=" + (tempStore >= 0 && tempStore <= 2 ? kTempStoreNames[tempStore] : "?")
+        + ", wal_autocheckpoint=" + pragma("wal_autocheckpoint") + ")";
+    QueryStats::instance().setDatabaseSettings(settings);
+    return true;
 }
 
 bool DatabaseManager::initializeDatabase() {
     // Conecta ao banco de dados
-    int rc = sqlite3_open(dbPath.c_str(), &db);
+    int rc;
+    if (options.inMemory) {
+        // FULLMUTEX: a gravação periódica usa a conexão a partir de outra thread
+        rc = sqlite3_open_v2(":memory:", &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr);
+        if (rc == SQLITE_OK && !loadFromDisk()) {
+            sqlite3_close(db);
+            return false;
+        }
+    } else if (options.readOnly) {
+        rc = sqlite3_open_v2(readOnlyUri(dbPath, options.immutable).c_str(), &db,
+                             SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, nullptr);
+    } else {
+        rc = sqlite3_open(dbPath.c_str(), &db);
+    }
     if (rc != SQLITE_OK) {
         std::cerr << "Erro ao abrir banco de dados: " << sqlite3_errmsg(db) << std::endl;
         sqlite3_close(db);
@@ -17,6 +258,74 @@ bool DatabaseManager::initializeDatabase() {
     }
     
     isConnected = true;
+    sqlite3_rollback_hook(db, &DatabaseManager::discardActivity, this);
+    int version = schemaVersion();
+
+    // Só de leitura: nada a criar nem a migrar, o esquema tem de estar na versão atual
+    if (options.readOnly) {
+        if (version != kSchemaVersion || !applyOptions()) {
+            if (version != kSchemaVersion) {
+                std::cerr << "Banco de dados " << dbPath << " sem o esquema atual (versão " << version
+                          << "); abra-o primeiro com o bank_system" << std::endl;
+            }
+            sqlite3_close(db);
+            isConnected = false;
+            return false;
+        }
+        return true;
+    }
+
+    // Bancos novos ficam com vacuum incremental (sem efeito num banco que já tem tabelas).
+    // Tem de vir antes do perfil: mudar o journal_mode grava o cabeçalho do arquivo.
+    if (version < kSchemaVersion) {
+        executeSql("PRAGMA auto_vacuum = INCREMENTAL;");
+    }
+
+    if (!applyOptions()) {
+        sqlite3_close(db);
+        isConnected = false;
+        return false;
+    }
+
+    // Banco já na versão atual: nada a criar nem a migrar
+    if (version == kSchemaVersion) {
+        return true;
+    }
+    if (version > kSchemaVersion) {
+        std::cerr << "Banco de dados criado por uma versão mais recente do programa (esquema "
+                  << version << ")" << std::endl;
+        sqlite3_close(db);
+        isConnected = false;
+        return false;
+    }
+
+    // As migrações correm antes de createTables, cujos índices já usam as colunas novas
+    if (hasColumn("companies", "id")) {
+        // Migra a coluna cnpj para nipc se necessário
+        if (!migrateCnpjToNipc()) {
+            std::cerr << "Erro ao migrar coluna cnpj para nipc" << std::endl;
+            sqlite3_close(db);
+            isConnected = false;
+            return false;
+        }
+
+        // Acrescenta a taxa de juros por empresa em bancos antigos
+        if (!migrateInterestRate()) {
+            std::cerr << "Erro ao adicionar coluna interest_rate" << std::endl;
+            sqlite3_close(db);
+            isConnected = false;
+            return false;
+        }
+
+        // NIPC inteiro, tarefas ligadas pelo id da empresa e deleted NOT NULL
+        // (recria as tabelas companies e tasks)
+        if (!migrateCompanyKeys()) {
+            std::cerr << "Erro ao converter NIPCs para inteiros" << std::endl;
+            sqlite3_close(db);
+            isConnected = false;
+            return false;
+        }
+    }
     
     // Cria as tabelas se não existirem
     if (!createTables()) {
@@ -26,17 +335,38 @@ bool DatabaseManager::initializeDatabase() {
         return false;
     }
 
-    // Migra a coluna cnpj para nipc se necessário
-    if (!migrateCnpjToNipc()) {
-        std::cerr << "Erro ao migrar coluna cnpj para nipc" << std::endl;
+    // Preenche os agregados de originação em bancos criados antes de existirem
+    if (!ensureLoanRollups()) {
+        std::cerr << "Erro ao preencher agregados de originação" << std::endl;
+        sqlite3_close(db);
+        isConnected = false;
+        return false;
+    }
+
+    // Só depois de tudo concluído; se algo falhar, o próximo arranque repete o processo
+    std::string stamp = "PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";";
+    if (!executeSql(stamp.c_str())) {
         sqlite3_close(db);
         isConnected = false;
         return false;
     }
+    schemaInitialized = true;
     
     return true;
 }
 
+int DatabaseManager::schemaVersion() {
+    sqlite3_stmt* stmt;
+    int version = 0;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            version = sqlite3_column_int(stmt, 0);
+        }
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
 bool DatabaseManager::migrateCnpjToNipc() {
     if (!isConnected) return false;
 
@@ -73,8 +403,159 @@ bool DatabaseManager::migrateCnpjToNipc() {
     return true;
 }
 
+bool DatabaseManager::hasColumn(const char* table, const char* column) {
+    std::string sql = std::string("PRAGMA table_info(") + table + ");";
+    sqlite3_stmt* stmt;
+    bool found = false;
+    
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* columnName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            if (columnName && std::strcmp(columnName, column) == 0) {
+                found = true;
+                break;
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+// Data AAAA-MM-DD de um dia que existe: normalizada pelo SQLite (o modificador obriga ao
+// cálculo), volta igual; "2026-02-30" passa a "2026-03-02" e texto inválido a NULL
+bool DatabaseManager::isIsoDate(const std::string& text) {
+    if (text.size() != 10) return false;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT date(?1, '+0 days') IS ?1;", -1, &stmt, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_text(stmt, 1, text.c_str(), -1, SQLITE_TRANSIENT);
+    bool valid = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) == 1;
+    sqlite3_finalize(stmt);
+    return valid;
+}
+
+bool DatabaseManager::migrateInterestRate() {
+    if (!isConnected) return false;
+    if (hasColumn("companies", "interest_rate")) return true;
+
+    // Empresas antigas ficam com a taxa do nível de risco médio
+    return executeSql("ALTER TABLE companies ADD COLUMN interest_rate REAL NOT NULL DEFAULT 0.08;");
+}
+
+// Esquema 3: o NIPC deixa de ser TEXT e passa a INTEGER, e as tarefas referenciam a empresa
+// pelo id em vez do NIPC em texto, para que pesquisas e junções comparem inteiros e os
+// índices fiquem menores. Na mesma reconstrução a coluna deleted, anulável em bancos antigos,
+// passa a NOT NULL. O SQLite não altera tipos nem restrições de colunas, por isso as duas
+// tabelas são recriadas (sem disparar os gatilhos de originação); os índices e gatilhos,
+// que desaparecem com as tabelas antigas, são recriados por createTables.
+bool DatabaseManager::migrateCompanyKeys() {
+    if (!isConnected) return false;
+
+    sqlite3_stmt* stmt;
+    bool integerNipc = false;
+    bool deletedNotNull = false;
+    if (sqlite3_prepare_v2(db, "PRAGMA table_info(companies);", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* columnName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            const char* columnType = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+            if (!columnName) continue;
+            if (std::strcmp(columnName, "nipc") == 0) {
+                integerNipc = columnType && std::strcmp(columnType, "INTEGER") == 0;
+            } else if (std::strcmp(columnName, "deleted") == 0) {
+                deletedNotNull = sqlite3_column_int(stmt, 3) != 0;
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+    bool tasksByNipc = hasColumn("tasks", "company_nipc");
+    if (integerNipc && deletedNotNull && !tasksByNipc) return true;
+
+    // Um NIPC que não seja um número de nove dígitos não tem conversão; a migração pára
+    // para que seja corrigido à mão, em vez de perder a empresa
+    const char* invalidSql = "SELECT id, nipc FROM companies WHERE replace(nipc, ' ', '') "
+                             "NOT GLOB '[1-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9]';";
+    int invalid = 0;
+    if (sqlite3_prepare_v2(db, invalidSql, -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* nipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            if (invalid++ < 10) {
+                std::cerr << "NIPC inválido na empresa " << sqlite3_column_int64(stmt, 0) << ": '"
+                          << (nipc ? nipc : "") << "'" << std::endl;
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (invalid > 0) {
+        std::cerr << invalid << " empresa(s) com NIPC que não tem nove dígitos; corrija-os antes de atualizar o banco"
+                  << std::endl;
+        return false;
+    }
+
+    std::string sql = std::string("BEGIN;"
+                                  "CREATE TABLE companies_rebuild (") + kCompanyColumns + ");"
+                      "INSERT INTO companies_rebuild (id, name, nipc, location, employee_name, loan_amount, "
+                      "loan_approved, balance, created_at, deleted, interest_rate) "
+                      "SELECT id, name, CAST(replace(nipc, ' ', '') AS INTEGER), location, employee_name, loan_amount, "
+                      "loan_approved, balance, created_at, COALESCE(deleted, 0), interest_rate FROM companies;"
+                      // Mantém o contador de AUTOINCREMENT, para que ids antigos não sejam reutilizados
+                      "UPDATE sqlite_sequence SET seq = (SELECT seq FROM sqlite_sequence WHERE name = 'companies') "
+                      "WHERE name = 'companies_rebuild';";
+    if (tasksByNipc) {
+        sql += std::string("CREATE TABLE tasks_rebuild (") + kTaskColumns + ");"
+               "INSERT INTO tasks_rebuild (id, description, completed, company_id, created_at, completed_at) "
+               "SELECT t.id, t.description, t.completed, c.id, t.created_at, t.completed_at FROM tasks t "
+               "JOIN companies_rebuild c ON c.nipc = CAST(replace(t.company_nipc, ' ', '') AS INTEGER);"
+               "UPDATE sqlite_sequence SET seq = (SELECT seq FROM sqlite_sequence WHERE name = 'tasks') "
+               "WHERE name = 'tasks_rebuild';";
+    }
+    if (!executeSql(sql.c_str())) {
+        executeSql("ROLLBACK;");
+        return false;
+    }
+
+    // Tarefas de NIPCs sem empresa não têm id a que ligar; ficam guardadas em tasks_orphaned
+    if (tasksByNipc) {
+        long long orphaned = 0;
+        if (sqlite3_prepare_v2(db, "SELECT (SELECT COUNT(*) FROM tasks) - (SELECT COUNT(*) FROM tasks_rebuild);",
+                               -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+            orphaned = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        if (orphaned > 0) {
+            if (!executeSql("CREATE TABLE IF NOT EXISTS tasks_orphaned AS SELECT * FROM tasks WHERE 0;"
+                            "INSERT INTO tasks_orphaned SELECT * FROM tasks "
+                            "WHERE id NOT IN (SELECT id FROM tasks_rebuild);")) {
+                executeSql("ROLLBACK;");
+                return false;
+            }
+            std::cerr << orphaned << " tarefa(s) de empresas inexistentes movida(s) para tasks_orphaned" << std::endl;
+        }
+    }
+
+    sql = tasksByNipc ? "DROP TABLE tasks;" : "";
+    sql += "DROP TABLE companies;"
+           "ALTER TABLE companies_rebuild RENAME TO companies;";
+    if (tasksByNipc) sql += "ALTER TABLE tasks_rebuild RENAME TO tasks;";
+    sql += "COMMIT;";
+    if (!executeSql(sql.c_str())) {
+        executeSql("ROLLBACK;");
+        return false;
+    }
+    return true;
+}
+
 DatabaseManager::~DatabaseManager() {
+    if (persistThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(persistMutex);
+            stopPersisting = true;
+        }
+        persistWake.notify_one();
+        persistThread.join();
+        persist();
+    }
     if (db) {
+        // Só sai o que já foi gravado; uma transação deixada aberta é desfeita ao fechar
+        publishActivity();
         sqlite3_close(db);
     }
 }
@@ -82,37 +563,103 @@ DatabaseManager::~DatabaseManager() {
 bool DatabaseManager::createTables() {
     if (!isConnected) return false;
     
-    const char* sql = "CREATE TABLE IF NOT EXISTS companies ("
-                     "id INTEGER PRIMARY KEY AUTOINCREMENT,"
-                     "name TEXT NOT NULL,"
-                     "nipc TEXT NOT NULL UNIQUE,"
-                     "location TEXT NOT NULL,"
-                     "employee_name TEXT NOT NULL,"
-                     "loan_amount REAL NOT NULL,"
-                     "loan_approved INTEGER NOT NULL DEFAULT 1,"
-                     "balance REAL DEFAULT 0.0,"
-                     "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-                     "deleted INTEGER DEFAULT 0"
+    std::string sql = std::string("CREATE TABLE IF NOT EXISTS companies (") + kCompanyColumns + ");"
+                     
+                     // Índice parcial (só empresas ativas) de cobertura para os agrupamentos por
+                     // localização e os totais. O SQLite usa um índice parcial em qualquer consulta
+                     // com deleted = 0, por isso as listagens completas pedem NOT INDEXED.
+                     "CREATE INDEX IF NOT EXISTS idx_companies_active_location "
+                     "ON companies (location, loan_amount, balance) WHERE deleted = 0;"
+                     "CREATE INDEX IF NOT EXISTS idx_companies_name ON companies (name);"
+                     
+                     "CREATE TABLE IF NOT EXISTS tasks (" + kTaskColumns + ");"
+                     
+                     // As tarefas de uma empresa já saem do índice pela ordem da listagem
+                     "CREATE INDEX IF NOT EXISTS idx_tasks_company ON tasks (company_id, created_at);"
+                     
+                     // Lançamentos de juros: no máximo um por empresa e por data
+                     "CREATE TABLE IF NOT EXISTS interest_accruals ("
+                     "accrual_date TEXT NOT NULL,"
+                     "company_id INTEGER NOT NULL,"
+                     "amount REAL NOT NULL,"
+                     "PRIMARY KEY (accrual_date, company_id)"
+                     ") WITHOUT ROWID;"
+                     
+                     // Progresso da rotina de juros por data, para retomar após interrupção
+                     "CREATE TABLE IF NOT EXISTS accrual_runs ("
+                     "accrual_date TEXT PRIMARY KEY,"
+                     "last_company_id INTEGER NOT NULL DEFAULT 0,"
+                     "accounts INTEGER NOT NULL DEFAULT 0,"
+                     "total_interest REAL NOT NULL DEFAULT 0.0,"
+                     "completed INTEGER NOT NULL DEFAULT 0"
                      ");"
                      
-                     "CREATE TABLE IF NOT EXISTS tasks ("
-                     "id INTEGER PRIMARY KEY AUTOINCREMENT,"
-                     "description TEXT NOT NULL,"
-                     "completed INTEGER NOT NULL DEFAULT 0,"
-                     "company_nipc TEXT NOT NULL,"
-                     "created_at INTEGER NOT NULL,"
-                     "completed_at INTEGER,"
-                     "FOREIGN KEY (company_nipc) REFERENCES companies(nipc)"
+                     // Plano de parcelas de cada empréstimo
+                     "CREATE TABLE IF NOT EXISTS installments ("
+                     "id INTEGER PRIMARY KEY,"
+                     "company_id INTEGER NOT NULL,"
+                     "number INTEGER NOT NULL,"
+                     "due_date TEXT NOT NULL,"
+                     "amount REAL NOT NULL,"
+                     "principal REAL NOT NULL,"
+                     "interest REAL NOT NULL,"
+                     "paid INTEGER NOT NULL DEFAULT 0,"
+                     "paid_at INTEGER,"
+                     "FOREIGN KEY (company_id) REFERENCES companies(id)"
                      ");"
                      
+                     // Só as parcelas em aberto entram no índice de vencimentos
+                     "CREATE INDEX IF NOT EXISTS idx_installments_due "
+                     "ON installments (due_date, id) WHERE paid = 0;"
+                     "CREATE INDEX IF NOT EXISTS idx_installments_company ON installments (company_id);"
+                     
                      "CREATE TABLE IF NOT EXISTS users ("
                      "id INTEGER PRIMARY KEY AUTOINCREMENT,"
                      "username TEXT NOT NULL UNIQUE,"
                      "password TEXT NOT NULL"
-                     ");";
+                     ");"
+                     
+                     // Agregados de originação por dia e por mês da criação do empréstimo.
+                     // Mantidos pelos gatilhos abaixo, para que relatórios por período
+                     // leiam algumas centenas de linhas em vez de toda a tabela companies.
+                     "CREATE TABLE IF NOT EXISTS loan_rollup_daily ("
+                     "day TEXT PRIMARY KEY,"
+                     "loan_count INTEGER NOT NULL DEFAULT 0,"
+                     "loan_volume REAL NOT NULL DEFAULT 0.0,"
+                     "default_count INTEGER NOT NULL DEFAULT 0"
+                     ") WITHOUT ROWID;"
+                     
+                     "CREATE TABLE IF NOT EXISTS loan_rollup_monthly ("
+                     "month TEXT PRIMARY KEY,"
+                     "loan_count INTEGER NOT NULL DEFAULT 0,"
+                     "loan_volume REAL NOT NULL DEFAULT 0.0,"
+                     "default_count INTEGER NOT NULL DEFAULT 0"
+                     ") WITHOUT ROWID;"
+                     
+                     "CREATE TRIGGER IF NOT EXISTS trg_companies_rollup_insert AFTER INSERT ON companies BEGIN "
+                     "INSERT INTO loan_rollup_daily (day, loan_count, loan_volume, default_count) "
+                     "VALUES (date(COALESCE(NEW.created_at, CURRENT_TIMESTAMP)), 1, NEW.loan_amount, NEW.balance < 0) "
+                     "ON CONFLICT(day) DO UPDATE SET loan_count = loan_count + 1, "
+                     "loan_volume = loan_volume + excluded.loan_volume, "
+                     "default_count = default_count + excluded.default_count; "
+                     "INSERT INTO loan_rollup_monthly (month, loan_count, loan_volume, default_count) "
+                     "VALUES (strftime('%Y-%m', COALESCE(NEW.created_at, CURRENT_TIMESTAMP)), 1, NEW.loan_amount, NEW.balance < 0) "
+                     "ON CONFLICT(month) DO UPDATE SET loan_count = loan_count + 1, "
+                     "loan_volume = loan_volume + excluded.loan_volume, "
+                     "default_count = default_count + excluded.default_count; "
+                     "END;"
+                     
+                     // Só atualiza quando o saldo passa de devedor para quitado ou vice-versa
+                     "CREATE TRIGGER IF NOT EXISTS trg_companies_rollup_balance AFTER UPDATE OF balance ON companies "
+                     "WHEN (OLD.balance < 0) <> (NEW.balance < 0) BEGIN "
+                     "UPDATE loan_rollup_daily SET default_count = default_count + (NEW.balance < 0) - (OLD.balance < 0) "
+                     "WHERE day = date(NEW.created_at); "
+                     "UPDATE loan_rollup_monthly SET default_count = default_count + (NEW.balance < 0) - (OLD.balance < 0) "
+                     "WHERE month = strftime('%Y-%m', NEW.created_at); "
+                     "END;";
     
     char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg);
     
     if (rc != SQLITE_OK) {
         std::cerr << "Erro ao criar tabelas: " << errMsg << std::endl;
@@ -123,8 +670,72 @@ bool DatabaseManager::createTables() {
     return true;
 }
 
+// Todos os COMMIT explícitos passam por aqui: a latência fica nas estatísticas junto do
+// perfil em vigor, porque é nela que o synchronous e o journal_mode mais pesam
+bool DatabaseManager::commit() {
+    QueryTimer timer(QueryOp::CommitTransaction);
+    if (!executeSql("COMMIT;")) return false;
+    publishActivity();
+    return true;
+}
+
+bool DatabaseManager::executeSql(const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erro ao executar SQL: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::ensureLoanRollups() {
+    if (!isConnected) return false;
+
+    const char* checkSql = "SELECT EXISTS (SELECT 1 FROM companies), EXISTS (SELECT 1 FROM loan_rollup_monthly);";
+    sqlite3_stmt* stmt;
+    bool needsBackfill = false;
+    if (sqlite3_prepare_v2(db, checkSql, -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            needsBackfill = sqlite3_column_int(stmt, 0) != 0 && sqlite3_column_int(stmt, 1) == 0;
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    return needsBackfill ? rebuildLoanRollups() : true;
+}
+
+// Recalcula os agregados de originação a partir da tabela companies
+bool DatabaseManager::rebuildLoanRollups() {
+    QueryTimer timer(QueryOp::RebuildLoanRollups);
+    if (!isConnected) return false;
+
+    const char* sql = "BEGIN;"
+                      "DELETE FROM loan_rollup_daily;"
+                      "DELETE FROM loan_rollup_monthly;"
+                      "INSERT INTO loan_rollup_daily (day, loan_count, loan_volume, default_count) "
+                      "SELECT date(created_at), COUNT(*), SUM(loan_amount), SUM(balance < 0) "
+                      "FROM companies WHERE created_at IS NOT NULL GROUP BY 1;"
+                      "INSERT INTO loan_rollup_monthly (month, loan_count, loan_volume, default_count) "
+                      "SELECT substr(day, 1, 7), SUM(loan_count), SUM(loan_volume), SUM(default_count) "
+                      "FROM loan_rollup_daily GROUP BY 1;"
+                      "COMMIT;";
+    if (!executeSql(sql)) {
+        executeSql("ROLLBACK;");
+        return false;
+    }
+    return true;
+}
+
 bool DatabaseManager::createCompany(const Company& company) {
+    QueryTimer timer(QueryOp::CreateCompany);
     if (!isConnected) return false;
+
+    long long nipc;
+    if (!parseNipc(company.getNIPC(), nipc) || !isValidNipc(nipc)) {
+        std::cerr << "NIPC inválido: " << company.getNIPC() << std::endl;
+        return false;
+    }
     
     const char* sql = "INSERT INTO companies (name, nipc, location, employee_name, loan_amount, loan_approved, balance) "
                      "VALUES (?, ?, ?, ?, ?, ?, ?);";
@@ -136,10 +747,13 @@ bool DatabaseManager::createCompany(const Company& company) {
         return false;
     }
     
-    sqlite3_bind_text(stmt, 1, company.getName().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, company.getNIPC().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, company.getLocation().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, company.getEmployeeName().c_str(), -1, SQLITE_STATIC);
+    std::string_view name = company.getName();
+    std::string_view location = company.getLocation();
+    std::string_view employeeName = company.getEmployeeName();
+    sqlite3_bind_text(stmt, 1, name.data(), static_cast<int>(name.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, nipc);
+    sqlite3_bind_text(stmt, 3, location.data(), static_cast<int>(location.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, employeeName.data(), static_cast<int>(employeeName.size()), SQLITE_STATIC);
     sqlite3_bind_double(stmt, 5, company.getLoanAmount());
     sqlite3_bind_int(stmt, 6, company.isLoanApproved() ? 1 : 0);
     sqlite3_bind_double(stmt, 7, company.getBalance());
@@ -152,14 +766,17 @@ bool DatabaseManager::createCompany(const Company& company) {
         return false;
     }
     
+    logActivity(ActivityType::CompanyCreated, nipc, company.getLoanAmount());
     return true;
 }
 
 std::vector<Company> DatabaseManager::getAllCompanies() {
+    QueryTimer timer(QueryOp::GetAllCompanies);
     std::vector<Company> companies;
     if (!isConnected) return companies;
     
-    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved FROM companies WHERE deleted = 0 OR deleted IS NULL ORDER BY created_at DESC;";
+    // Listagem completa: ler a tabela diretamente é mais rápido do que percorrer o índice parcial
+    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved FROM companies NOT INDEXED WHERE deleted = 0 ORDER BY created_at DESC;";
     sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -168,20 +785,20 @@ std::vector<Company> DatabaseManager::getAllCompanies() {
         return companies;
     }
     
+    PROBE_SCOPE("getAllCompanies.scan");
     while (sqlite3_step(stmt) == SQLITE_ROW) {
+        PROBE_SCOPE("getAllCompanies.row");
         const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        const char* nipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        char nipcText[kNipcDigits];
+        std::string_view nipc = columnNipc(stmt, 1, nipcText);
         const char* location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         const char* employeeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         double loanAmount = sqlite3_column_double(stmt, 4);
         bool loanApproved = sqlite3_column_int(stmt, 5) != 0;
         
-        if (name && nipc && location && employeeName) {
-            Company company(name, nipc, location, employeeName, loanAmount);
-            if (!loanApproved) {
-                *(bool*)((char*)&company + sizeof(std::string)*4 + sizeof(double)) = false;
-            }
-            companies.push_back(company);
+        if (name && location && employeeName) {
+            companies.emplace_back(name, nipc, location, employeeName, loanAmount);
+            companies.back().setLoanApproved(loanApproved);
         }
     }
     
@@ -189,11 +806,57 @@ std::vector<Company> DatabaseManager::getAllCompanies() {
     return companies;
 }
 
+bool DatabaseManager::getAllCompanies(CompanyResultSet& result) {
+    QueryTimer timer(QueryOp::GetAllCompanies);
+    result.clear();
+    if (!isConnected) return false;
+    
+    // Listagem completa: ler a tabela diretamente é mais rápido do que percorrer o índice parcial
+    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved FROM companies NOT INDEXED WHERE deleted = 0 ORDER BY created_at DESC;";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Erro ao preparar consulta: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    
+    // O texto é copiado para a arena do resultado, sem passar pelo StringPool
+    PROBE_SCOPE("getAllCompanies.scan");
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        PROBE_SCOPE("getAllCompanies.row");
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        char nipcText[kNipcDigits];
+        std::string_view nipc = columnNipc(stmt, 1, nipcText);
+        const char* location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        const char* employeeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        if (!name || !location || !employeeName) continue;
+        
+        CompanyRow& company = result.emplace_back();
+        company.name = result.copy(std::string_view(name, sqlite3_column_bytes(stmt, 0)));
+        company.nipc = result.copy(nipc);
+        company.location = result.copy(std::string_view(location, sqlite3_column_bytes(stmt, 2)));
+        company.employeeName = result.copy(std::string_view(employeeName, sqlite3_column_bytes(stmt, 3)));
+        company.loanAmount = sqlite3_column_double(stmt, 4);
+        // Como em Company, a listagem mostra o saldo inicial do empréstimo
+        company.balance = -company.loanAmount;
+        company.loanApproved = sqlite3_column_int(stmt, 5) != 0;
+    }
+    
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Erro ao ler empresas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool DatabaseManager::deleteCompany(const std::string& companyName) {
+    QueryTimer timer(QueryOp::DeleteCompany);
     if (!isConnected) return false;
 
-    // Primeiro, remove a empresa
-    std::string sql = "UPDATE companies SET deleted = 1 WHERE name = ?;";
+    // Marca a empresa como removida; o NIPC devolvido vai para o registo de atividades
+    std::string sql = "UPDATE companies SET deleted = 1 WHERE name = ? AND deleted = 0 RETURNING nipc;";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -203,14 +866,17 @@ bool DatabaseManager::deleteCompany(const std::string& companyName) {
 
     sqlite3_bind_text(stmt, 1, companyName.c_str(), -1, SQLITE_STATIC);
     
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    std::vector<sqlite3_int64> removed;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        removed.push_back(sqlite3_column_int64(stmt, 0));
+    }
     sqlite3_finalize(stmt);
 
+    bool success = rc == SQLITE_DONE;
     if (success) {
-        // Se a empresa foi removida com sucesso, limpa o histórico
-        std::ofstream logFile("log.txt", std::ios::trunc);
-        if (logFile.is_open()) {
-            logFile.close();
+        for (sqlite3_int64 nipc : removed) {
+            logActivity(ActivityType::CompanyDeleted, nipc, 0.0);
         }
     }
     
@@ -218,6 +884,7 @@ bool DatabaseManager::deleteCompany(const std::string& companyName) {
 }
 
 Company DatabaseManager::getCompany(const std::string& nipc) {
+    QueryTimer timer(QueryOp::GetCompany);
     Company company("", "", "", "", 0.0);
     std::string sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance "
                      "FROM companies WHERE nipc = ? AND deleted = 0;";
@@ -226,11 +893,12 @@ Company DatabaseManager::getCompany(const std::string& nipc) {
     int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     
     if (rc == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, nipc.c_str(), -1, SQLITE_STATIC);
+        bindNipc(stmt, 1, nipc);
         
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            std::string nipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            char nipcText[kNipcDigits];
+            std::string_view nipc = columnNipc(stmt, 1, nipcText);
             std::string location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
             std::string employeeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
             double loanAmount = sqlite3_column_double(stmt, 4);
@@ -238,6 +906,7 @@ Company DatabaseManager::getCompany(const std::string& nipc) {
             double balance = sqlite3_column_double(stmt, 6);
             
             company = Company(name, nipc, location, employeeName, loanAmount);
+            company.setLoanApproved(loanApproved);
             company.setBalance(balance);
         }
     }
@@ -247,6 +916,16 @@ Company DatabaseManager::getCompany(const std::string& nipc) {
 }
 
 bool DatabaseManager::updateCompanyBalance(const std::string& nipc, double amount) {
+    QueryTimer timer(QueryOp::UpdateCompanyBalance);
+    if (!changeBalance(nipc, amount)) return false;
+    if (sqlite3_changes(db) > 0) {
+        logActivity(ActivityType::BalanceChange, nipc, amount);
+    }
+    return true;
+}
+
+// Atualização do saldo sem registo de atividade, partilhada com addLoanToCompany
+bool DatabaseManager::changeBalance(const std::string& nipc, double amount) {
     std::string sql = "UPDATE companies SET balance = balance + ? WHERE nipc = ? AND deleted = 0;";
     
     sqlite3_stmt* stmt;
@@ -254,7 +933,7 @@ bool DatabaseManager::updateCompanyBalance(const std::string& nipc, double amoun
     
     if (rc == SQLITE_OK) {
         sqlite3_bind_double(stmt, 1, amount);
-        sqlite3_bind_text(stmt, 2, nipc.c_str(), -1, SQLITE_STATIC);
+        bindNipc(stmt, 2, nipc);
         
         rc = sqlite3_step(stmt);
         sqlite3_finalize(stmt);
@@ -266,14 +945,53 @@ bool DatabaseManager::updateCompanyBalance(const std::string& nipc, double amoun
     return false;
 }
 
+bool DatabaseManager::addLoanToCompany(const std::string& nipc, double amount) {
+    QueryTimer timer(QueryOp::AddLoanToCompany);
+    if (!isConnected) return false;
+    if (!executeSql("SAVEPOINT add_loan;")) return false;
+
+    if (!changeBalance(nipc, -amount) || sqlite3_changes(db) == 0) {
+        executeSql("ROLLBACK TO add_loan; RELEASE add_loan;");
+        return false;
+    }
+
+    const char* sql = "INSERT INTO loan_rollup_daily (day, loan_count, loan_volume) VALUES (date('now'), 1, ?1) "
+                      "ON CONFLICT(day) DO UPDATE SET loan_count = loan_count + 1, loan_volume = loan_volume + excluded.loan_volume;"
+                      "INSERT INTO loan_rollup_monthly (month, loan_count, loan_volume) VALUES (strftime('%Y-%m', 'now'), 1, ?1) "
+                      "ON CONFLICT(month) DO UPDATE SET loan_count = loan_count + 1, loan_volume = loan_volume + excluded.loan_volume;";
+    const char* next = sql;
+    bool success = true;
+    while (success && next && *next) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, next, -1, &stmt, &next) != SQLITE_OK) {
+            std::cerr << "Erro ao preparar agregado de originação: " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+            break;
+        }
+        if (!stmt) break;
+        sqlite3_bind_double(stmt, 1, amount);
+        success = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+    }
+
+    if (!success) {
+        executeSql("ROLLBACK TO add_loan; RELEASE add_loan;");
+        return false;
+    }
+    if (!executeSql("RELEASE add_loan;")) return false;
+    logActivity(ActivityType::Loan, nipc, amount);
+    return true;
+}
+
 double DatabaseManager::getCompanyBalance(const std::string& nipc) {
+    QueryTimer timer(QueryOp::GetCompanyBalance);
     std::string sql = "SELECT balance FROM companies WHERE nipc = ? AND deleted = 0;";
     
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     
     if (rc == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, nipc.c_str(), -1, SQLITE_STATIC);
+        bindNipc(stmt, 1, nipc);
         
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             double balance = sqlite3_column_double(stmt, 0);
@@ -287,10 +1005,12 @@ double DatabaseManager::getCompanyBalance(const std::string& nipc) {
 }
 
 bool DatabaseManager::createTask(const Task& task) {
+    QueryTimer timer(QueryOp::CreateTask);
     if (!isConnected) return false;
     
-    const char* sql = "INSERT INTO tasks (description, completed, company_nipc, created_at, completed_at) "
-                     "VALUES (?, ?, ?, ?, ?);";
+    // A tarefa fica ligada ao id da empresa; um NIPC sem empresa não insere nada
+    const char* sql = "INSERT INTO tasks (description, completed, company_id, created_at, completed_at) "
+                     "SELECT ?, ?, id, ?, ? FROM companies WHERE nipc = ?;";
     sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -299,19 +1019,23 @@ bool DatabaseManager::createTask(const Task& task) {
         return false;
     }
     
-    sqlite3_bind_text(stmt, 1, task.getDescription().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, task.getDescription().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, task.isCompleted() ? 1 : 0);
-    sqlite3_bind_text(stmt, 3, task.getCompanyNipc().c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int64(stmt, 4, task.getCreatedAt());
-    sqlite3_bind_int64(stmt, 5, task.getCompletedAt());
+    sqlite3_bind_int64(stmt, 3, task.getCreatedAt());
+    sqlite3_bind_int64(stmt, 4, task.getCompletedAt());
+    bindNipc(stmt, 5, task.getCompanyNipc());
     
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE || sqlite3_changes(db) == 0) return false;
+    logActivity(ActivityType::TaskCreated, task.getCompanyNipc(), 0.0, sqlite3_last_insert_rowid(db),
+                task.isCompleted() ? kActivityTaskCompleted : 0);
+    return true;
 }
 
 bool DatabaseManager::deleteTask(int taskId) {
+    QueryTimer timer(QueryOp::DeleteTask);
     if (!isConnected) return false;
     
     const char* sql = "DELETE FROM tasks WHERE id = ?;";
@@ -328,10 +1052,15 @@ bool DatabaseManager::deleteTask(int taskId) {
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) return false;
+    if (sqlite3_changes(db) > 0) {
+        logActivity(ActivityType::TaskDeleted, 0, 0.0, taskId);
+    }
+    return true;
 }
 
 bool DatabaseManager::updateTaskStatus(int taskId, bool completed) {
+    QueryTimer timer(QueryOp::UpdateTaskStatus);
     if (!isConnected) return false;
     
     const char* sql = "UPDATE tasks SET completed = ?, completed_at = ? WHERE id = ?;";
@@ -350,15 +1079,22 @@ bool DatabaseManager::updateTaskStatus(int taskId, bool completed) {
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
     
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) return false;
+    if (sqlite3_changes(db) > 0) {
+        logActivity(ActivityType::TaskStatusChanged, 0, 0.0, taskId,
+                    completed ? kActivityTaskCompleted : 0);
+    }
+    return true;
 }
 
 std::vector<Task> DatabaseManager::getCompanyTasks(const std::string& companyNipc) {
+    QueryTimer timer(QueryOp::GetCompanyTasks);
     std::vector<Task> tasks;
     if (!isConnected) return tasks;
     
     const char* sql = "SELECT id, description, completed, created_at, completed_at "
-                     "FROM tasks WHERE company_nipc = ? ORDER BY created_at DESC;";
+                     "FROM tasks WHERE company_id = (SELECT id FROM companies WHERE nipc = ?) "
+                     "ORDER BY created_at DESC;";
     sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
@@ -367,7 +1103,7 @@ std::vector<Task> DatabaseManager::getCompanyTasks(const std::string& companyNip
         return tasks;
     }
     
-    sqlite3_bind_text(stmt, 1, companyNipc.c_str(), -1, SQLITE_STATIC);
+    bindNipc(stmt, 1, companyNipc);
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         int id = sqlite3_column_int(stmt, 0);
@@ -388,38 +1124,161 @@ std::vector<Task> DatabaseManager::getCompanyTasks(const std::string& companyNip
 
 std::vector<Task> DatabaseManager::getAllTasks() {
     std::vector<Task> tasks;
-    if (!isConnected) return tasks;
+    TaskResultSet rows;
+    if (!getAllTasks(rows)) return tasks;
     
-    const char* sql = "SELECT id, description, completed, company_nipc, created_at, completed_at "
-                     "FROM tasks ORDER BY created_at DESC;";
-    sqlite3_stmt* stmt;
+    tasks.reserve(rows.size());
+    for (const TaskRow& row : rows) {
+        tasks.emplace_back(row.id, std::string(row.description), row.completed,
+                           std::string(row.companyNipc), row.createdAt, row.completedAt);
+    }
+    return tasks;
+}
+
+bool DatabaseManager::getCompanyTasks(const std::string& companyNipc, TaskResultSet& result) {
+    QueryTimer timer(QueryOp::GetCompanyTasks);
+    result.clear();
+    if (!isConnected) return false;
+    
+    const char* sql = "SELECT id, description, completed, created_at, completed_at "
+                     "FROM tasks WHERE company_id = (SELECT id FROM companies WHERE nipc = ?) "
+                     "ORDER BY created_at DESC;";
+    sqlite3_stmt* stmt;
     
     int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (rc != SQLITE_OK) {
         std::cerr << "Erro ao preparar consulta de tarefas: " << sqlite3_errmsg(db) << std::endl;
-        return tasks;
+        return false;
     }
     
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
+    bindNipc(stmt, 1, companyNipc);
+    // Todas as linhas partilham a mesma cópia do NIPC
+    std::string_view nipc = result.copy(companyNipc);
+    
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         const char* description = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        bool completed = sqlite3_column_int(stmt, 2) != 0;
-        const char* companyNipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        time_t createdAt = sqlite3_column_int64(stmt, 4);
-        time_t completedAt = sqlite3_column_int64(stmt, 5);
+        if (!description) continue;
         
-        if (description && companyNipc) {
-            Task task(id, description, completed, companyNipc, createdAt, completedAt);
-            tasks.push_back(task);
-        }
+        TaskRow& task = result.emplace_back();
+        task.id = sqlite3_column_int(stmt, 0);
+        task.description = result.copy(std::string_view(description, sqlite3_column_bytes(stmt, 1)));
+        task.completed = sqlite3_column_int(stmt, 2) != 0;
+        task.companyNipc = nipc;
+        task.createdAt = sqlite3_column_int64(stmt, 3);
+        task.completedAt = sqlite3_column_int64(stmt, 4);
     }
     
     sqlite3_finalize(stmt);
-    return tasks;
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Erro ao ler tarefas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::getAllTasks(TaskResultSet& result) {
+    QueryTimer timer(QueryOp::GetAllTasks);
+    result.clear();
+    if (!isConnected) return false;
+    
+    // Sem junção com companies: os NIPCs são lidos no fim por resolveTaskNipcs
+    const char* sql = "SELECT id, description, completed, company_id, created_at, completed_at "
+                     "FROM tasks ORDER BY created_at DESC;";
+    sqlite3_stmt* stmt;
+    
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Erro ao preparar consulta de tarefas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    // As duas leituras veem o mesmo estado do banco
+    if (!executeSql("SAVEPOINT read_tasks;")) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    
+    std::vector<sqlite3_int64> companyIds;
+    PROBE_SCOPE("getAllTasks");
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        PROBE_SCOPE("getAllTasks.row");
+        const char* description = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (!description) continue;
+        
+        TaskRow& task = result.emplace_back();
+        task.id = sqlite3_column_int(stmt, 0);
+        task.description = result.copy(std::string_view(description, sqlite3_column_bytes(stmt, 1)));
+        task.completed = sqlite3_column_int(stmt, 2) != 0;
+        task.createdAt = sqlite3_column_int64(stmt, 4);
+        task.completedAt = sqlite3_column_int64(stmt, 5);
+        companyIds.push_back(sqlite3_column_int64(stmt, 3));
+    }
+    
+    sqlite3_finalize(stmt);
+    bool success = rc == SQLITE_DONE;
+    if (!success) {
+        std::cerr << "Erro ao ler tarefas: " << sqlite3_errmsg(db) << std::endl;
+    }
+    success = success && resolveTaskNipcs(result, companyIds);
+    executeSql("RELEASE read_tasks;");
+    return success;
+}
+
+// Preenche o NIPC de cada tarefa de result (companyIds[i] é a empresa de result[i]).
+// Uma junção na consulta das tarefas, ordenada por data, faria um acesso aleatório à
+// tabela companies por tarefa; aqui cada empresa é lida uma única vez e por ordem de id,
+// pelo que as páginas da tabela são percorridas em sequência: numa única leitura do
+// intervalo de ids, se as empresas das tarefas forem uma boa parte dele, ou com uma
+// pesquisa por empresa. Cada NIPC é copiado uma vez para a arena e partilhado pelas
+// tarefas da mesma empresa.
+bool DatabaseManager::resolveTaskNipcs(TaskResultSet& result, const std::vector<sqlite3_int64>& companyIds) {
+    PROBE_SCOPE("resolveTaskNipcs");
+    std::vector<sqlite3_int64> ids(companyIds);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    if (ids.empty()) return true;
+    
+    bool dense = static_cast<sqlite3_int64>(ids.size()) * 4 >= ids.back() - ids.front() + 1;
+    const char* sql = dense ? "SELECT id, nipc FROM companies WHERE id BETWEEN ?1 AND ?2 ORDER BY id;"
+                            : "SELECT id, nipc FROM companies WHERE id = ?1;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar consulta de NIPCs: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    std::vector<std::string_view> nipcs(ids.size());
+    char nipcText[kNipcDigits];
+    if (dense) {
+        sqlite3_bind_int64(stmt, 1, ids.front());
+        sqlite3_bind_int64(stmt, 2, ids.back());
+        size_t next = 0;
+        while (next < ids.size() && sqlite3_step(stmt) == SQLITE_ROW) {
+            sqlite3_int64 id = sqlite3_column_int64(stmt, 0);
+            while (next < ids.size() && ids[next] < id) next++;
+            if (next < ids.size() && ids[next] == id) {
+                nipcs[next++] = result.copy(columnNipc(stmt, 1, nipcText));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < ids.size(); i++) {
+            sqlite3_bind_int64(stmt, 1, ids[i]);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                nipcs[i] = result.copy(columnNipc(stmt, 1, nipcText));
+            }
+            sqlite3_reset(stmt);
+        }
+    }
+    sqlite3_finalize(stmt);
+    
+    for (size_t row = 0; row < result.size(); row++) {
+        size_t index = std::lower_bound(ids.begin(), ids.end(), companyIds[row]) - ids.begin();
+        result[row].companyNipc = nipcs[index];
+    }
+    return true;
 }
 
 // Autenticação de usuário
 bool DatabaseManager::authenticateUser(const std::string& username, const std::string& password) {
+    QueryTimer timer(QueryOp::AuthenticateUser);
     if (!isConnected) return false;
     const char* sql = "SELECT password FROM users WHERE username = ?;";
     sqlite3_stmt* stmt;
@@ -436,6 +1295,7 @@ bool DatabaseManager::authenticateUser(const std::string& username, const std::s
 
 // Criação de usuário
 bool DatabaseManager::createUser(const std::string& username, const std::string& password) {
+    QueryTimer timer(QueryOp::CreateUser);
     if (!isConnected) return false;
     const char* sql = "INSERT OR IGNORE INTO users (username, password) VALUES (?, ?);";
     sqlite3_stmt* stmt;
@@ -449,28 +1309,32 @@ bool DatabaseManager::createUser(const std::string& username, const std::string&
 
 // Busca empresa por NIPC ou nome
 Company DatabaseManager::getCompanyByNipcOrName(const std::string& nipcOrName) {
+    QueryTimer timer(QueryOp::GetCompanyByNipcOrName);
     if (!isConnected) return Company();
-    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance FROM companies WHERE (nipc = ? OR name = ?) AND (deleted = 0 OR deleted IS NULL) LIMIT 1;";
+    // Duas consultas unidas, para que cada uma use o seu índice (um OR leria a tabela inteira)
+    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance FROM companies "
+                      "WHERE nipc = ?1 AND deleted = 0 "
+                      "UNION ALL "
+                      "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance FROM companies "
+                      "WHERE name = ?2 AND deleted = 0 LIMIT 1;";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return Company();
-    sqlite3_bind_text(stmt, 1, nipcOrName.c_str(), -1, SQLITE_STATIC);
+    bindNipc(stmt, 1, nipcOrName);
     sqlite3_bind_text(stmt, 2, nipcOrName.c_str(), -1, SQLITE_STATIC);
     Company company;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        const char* nipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        char nipcText[kNipcDigits];
+        std::string_view nipc = columnNipc(stmt, 1, nipcText);
         const char* location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         const char* employeeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         double loanAmount = sqlite3_column_double(stmt, 4);
         bool loanApproved = sqlite3_column_int(stmt, 5) != 0;
         double balance = sqlite3_column_double(stmt, 6);
-        if (name && nipc && location && employeeName) {
+        if (name && location && employeeName) {
             company = Company(name, nipc, location, employeeName, loanAmount);
-            if (!loanApproved) {
-                *(bool*)((char*)&company + sizeof(std::string)*4 + sizeof(double)) = false;
-            }
-            // Set balance if method exists
-            *(double*)((char*)&company + sizeof(std::string)*4 + sizeof(double) + sizeof(bool)) = balance;
+            company.setLoanApproved(loanApproved);
+            company.setBalance(balance);
         }
     }
     sqlite3_finalize(stmt);
@@ -480,8 +1344,9 @@ Company DatabaseManager::getCompanyByNipcOrName(const std::string& nipcOrName) {
 // Relatórios
 // Total emprestado
 double DatabaseManager::getTotalEmprestado() {
+    QueryTimer timer(QueryOp::GetTotalEmprestado);
     if (!isConnected) return 0.0;
-    const char* sql = "SELECT SUM(loan_amount) FROM companies WHERE deleted = 0 OR deleted IS NULL;";
+    const char* sql = "SELECT SUM(loan_amount) FROM companies WHERE deleted = 0;";
     sqlite3_stmt* stmt;
     double total = 0.0;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -496,8 +1361,9 @@ double DatabaseManager::getTotalEmprestado() {
 // Considera o saldo positivo como recebido
 // (pode ser ajustado conforme lógica de negócio)
 double DatabaseManager::getTotalRecebido() {
+    QueryTimer timer(QueryOp::GetTotalRecebido);
     if (!isConnected) return 0.0;
-    const char* sql = "SELECT SUM(balance) FROM companies WHERE deleted = 0 OR deleted IS NULL;";
+    const char* sql = "SELECT SUM(balance) FROM companies WHERE deleted = 0;";
     sqlite3_stmt* stmt;
     double total = 0.0;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -511,32 +1377,733 @@ double DatabaseManager::getTotalRecebido() {
 // Saldo geral
 // (total recebido - total emprestado)
 double DatabaseManager::getSaldoGeral() {
+    QueryTimer timer(QueryOp::GetSaldoGeral);
     return getTotalRecebido() - getTotalEmprestado();
 }
 // Empresas inadimplentes (saldo devedor > 0)
 std::vector<Company> DatabaseManager::getEmpresasInadimplentes() {
+    QueryTimer timer(QueryOp::GetEmpresasInadimplentes);
     std::vector<Company> inadimplentes;
     if (!isConnected) return inadimplentes;
-    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance FROM companies WHERE (deleted = 0 OR deleted IS NULL) AND balance < 0;";
+    const char* sql = "SELECT name, nipc, location, employee_name, loan_amount, loan_approved, balance FROM companies NOT INDEXED WHERE deleted = 0 AND balance < 0;";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return inadimplentes;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        const char* nipc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        char nipcText[kNipcDigits];
+        std::string_view nipc = columnNipc(stmt, 1, nipcText);
         const char* location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         const char* employeeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         double loanAmount = sqlite3_column_double(stmt, 4);
         bool loanApproved = sqlite3_column_int(stmt, 5) != 0;
         double balance = sqlite3_column_double(stmt, 6);
-        if (name && nipc && location && employeeName) {
-            Company company(name, nipc, location, employeeName, loanAmount);
-            if (!loanApproved) {
-                *(bool*)((char*)&company + sizeof(std::string)*4 + sizeof(double)) = false;
-            }
-            *(double*)((char*)&company + sizeof(std::string)*4 + sizeof(double) + sizeof(bool)) = balance;
-            inadimplentes.push_back(company);
+        if (name && location && employeeName) {
+            inadimplentes.emplace_back(name, nipc, location, employeeName, loanAmount);
+            inadimplentes.back().setLoanApproved(loanApproved);
+            inadimplentes.back().setBalance(balance);
         }
     }
     sqlite3_finalize(stmt);
     return inadimplentes;
-} 
\ No newline at end of file
+} 
+// Tendências: agregação por localização e estatísticas dos valores, feitas no SQLite
+TrendReport DatabaseManager::getTrendReport() {
+    QueryTimer timer(QueryOp::GetTrendReport);
+    TrendReport report;
+    report.amounts = LoanAmountStats{0, 0.0, 0.0, 0.0};
+    if (!isConnected) return report;
+
+    const char* byLocationSql = "SELECT location, COUNT(*), SUM(loan_amount) FROM companies "
+                                "WHERE deleted = 0 GROUP BY location ORDER BY location;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, byLocationSql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar relatório por localização: " << sqlite3_errmsg(db) << std::endl;
+        return report;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        PROBE_SCOPE("getTrendReport.location");
+        const char* location = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        LocationSummary summary;
+        summary.location = location ? location : "";
+        summary.loanCount = sqlite3_column_int(stmt, 1);
+        summary.totalAmount = sqlite3_column_double(stmt, 2);
+        report.locations.push_back(summary);
+    }
+    sqlite3_finalize(stmt);
+
+    const char* statsSql = "SELECT COUNT(*), MIN(loan_amount), MAX(loan_amount), AVG(loan_amount) FROM companies "
+                           "WHERE deleted = 0;";
+    if (sqlite3_prepare_v2(db, statsSql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar estatísticas de valores: " << sqlite3_errmsg(db) << std::endl;
+        return report;
+    }
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        report.amounts.loanCount = sqlite3_column_int(stmt, 0);
+        report.amounts.minAmount = sqlite3_column_double(stmt, 1);
+        report.amounts.maxAmount = sqlite3_column_double(stmt, 2);
+        report.amounts.averageAmount = sqlite3_column_double(stmt, 3);
+    }
+    sqlite3_finalize(stmt);
+    return report;
+}
+
+// Originação por mês entre duas datas.
+// Meses inteiramente dentro do intervalo vêm da tabela mensal; apenas o primeiro e o
+// último mês, possivelmente parciais, são somados a partir da tabela diária.
+bool DatabaseManager::getOriginationReport(const std::string& fromDate, const std::string& toDate,
+                                           std::vector<OriginationBucket>& buckets) {
+    QueryTimer timer(QueryOp::GetOriginationReport);
+    buckets.clear();
+    if (!isConnected) return false;
+    if (!isIsoDate(fromDate) || !isIsoDate(toDate) || fromDate > toDate) return false;
+
+    const char* sql = "SELECT month, loan_count, loan_volume, default_count FROM loan_rollup_monthly "
+                      "WHERE month > substr(?1, 1, 7) AND month < substr(?2, 1, 7) "
+                      "UNION ALL "
+                      "SELECT substr(day, 1, 7), SUM(loan_count), SUM(loan_volume), SUM(default_count) "
+                      "FROM loan_rollup_daily "
+                      "WHERE day >= ?1 AND day <= ?2 AND day < date(?1, 'start of month', '+1 month') "
+                      "GROUP BY 1 "
+                      "UNION ALL "
+                      "SELECT substr(day, 1, 7), SUM(loan_count), SUM(loan_volume), SUM(default_count) "
+                      "FROM loan_rollup_daily "
+                      "WHERE day >= date(?2, 'start of month') AND day >= ?1 AND day <= ?2 "
+                      "AND substr(?1, 1, 7) <> substr(?2, 1, 7) "
+                      "GROUP BY 1 "
+                      "ORDER BY 1;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar relatório de originação: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, fromDate.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, toDate.c_str(), -1, SQLITE_STATIC);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* period = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        OriginationBucket bucket;
+        bucket.period = period ? period : "";
+        bucket.loanCount = sqlite3_column_int(stmt, 1);
+        bucket.loanVolume = sqlite3_column_double(stmt, 2);
+        bucket.defaultCount = sqlite3_column_int(stmt, 3);
+        buckets.push_back(bucket);
+    }
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool DatabaseManager::setCompanyInterestRate(const std::string& nipc, double annualRate) {
+    QueryTimer timer(QueryOp::SetCompanyInterestRate);
+    if (!isConnected) return false;
+    const char* sql = "UPDATE companies SET interest_rate = ? WHERE nipc = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_double(stmt, 1, annualRate);
+    bindNipc(stmt, 2, nipc);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// Rotina de juros.
+// Cada bloco de empresas (por intervalo de id) é tratado numa transação com três
+// instruções sobre conjuntos: grava os lançamentos do bloco, aplica-os aos saldos e
+// avança o progresso em accrual_runs. Como o progresso é gravado junto com os
+// lançamentos, uma nova execução para a mesma data continua de onde parou.
+bool DatabaseManager::accrueInterest(const std::string& accrualDate, AccrualResult& result, int chunkSize) {
+    QueryTimer timer(QueryOp::AccrueInterest);
+    auto start = std::chrono::steady_clock::now();
+    result.accrualDate = accrualDate;
+    result.accounts = 0;
+    result.chunks = 0;
+    result.totalInterest = 0.0;
+    result.elapsedSeconds = 0.0;
+    result.alreadyCompleted = false;
+    if (!isConnected || chunkSize <= 0) return false;
+    // A data é a chave de idempotência em accrual_runs: outra grafia do mesmo dia lançaria os juros outra vez
+    if (!isIsoDate(accrualDate)) {
+        std::cerr << "Data de juros inválida (AAAA-MM-DD): " << accrualDate << std::endl;
+        return false;
+    }
+
+    const char* runSql = "INSERT OR IGNORE INTO accrual_runs (accrual_date) VALUES (?1);"
+                         "SELECT last_company_id, completed FROM accrual_runs WHERE accrual_date = ?1;";
+    const char* boundSql = "SELECT MAX(id) FROM (SELECT id FROM companies WHERE id > ?1 ORDER BY id LIMIT ?2);";
+    const char* insertSql = "INSERT INTO interest_accruals (accrual_date, company_id, amount) "
+                            "SELECT ?1, id, balance * interest_rate / 365.0 FROM companies "
+                            "WHERE id > ?2 AND id <= ?3 AND balance < 0 AND deleted = 0;";
+    const char* applySql = "UPDATE companies SET balance = balance + a.amount "
+                           "FROM interest_accruals AS a "
+                           "WHERE a.accrual_date = ?1 AND a.company_id = companies.id "
+                           "AND companies.id > ?2 AND companies.id <= ?3;";
+    const char* progressSql = "UPDATE accrual_runs SET last_company_id = ?3, "
+                              "accounts = accounts + (SELECT COUNT(*) FROM interest_accruals "
+                              "WHERE accrual_date = ?1 AND company_id > ?2 AND company_id <= ?3), "
+                              "total_interest = total_interest + (SELECT COALESCE(SUM(amount), 0) FROM interest_accruals "
+                              "WHERE accrual_date = ?1 AND company_id > ?2 AND company_id <= ?3) "
+                              "WHERE accrual_date = ?1;";
+    const char* completeSql = "UPDATE accrual_runs SET completed = 1 WHERE accrual_date = ?1;";
+    const char* totalsSql = "SELECT accounts, total_interest FROM accrual_runs WHERE accrual_date = ?1;";
+
+    // Registra a execução e lê o progresso
+    sqlite3_int64 lastId = 0;
+    bool completed = false;
+    const char* next = runSql;
+    while (next && *next) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, next, -1, &stmt, &next) != SQLITE_OK) {
+            std::cerr << "Erro ao preparar rotina de juros: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        if (!stmt) break;
+        sqlite3_bind_text(stmt, 1, accrualDate.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            lastId = sqlite3_column_int64(stmt, 0);
+            completed = sqlite3_column_int(stmt, 1) != 0;
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    if (!completed) {
+        sqlite3_stmt* boundStmt = nullptr;
+        sqlite3_stmt* insertStmt = nullptr;
+        sqlite3_stmt* applyStmt = nullptr;
+        sqlite3_stmt* progressStmt = nullptr;
+        sqlite3_stmt* completeStmt = nullptr;
+        bool prepared = sqlite3_prepare_v2(db, boundSql, -1, &boundStmt, nullptr) == SQLITE_OK
+                     && sqlite3_prepare_v2(db, insertSql, -1, &insertStmt, nullptr) == SQLITE_OK
+                     && sqlite3_prepare_v2(db, applySql, -1, &applyStmt, nullptr) == SQLITE_OK
+                     && sqlite3_prepare_v2(db, progressSql, -1, &progressStmt, nullptr) == SQLITE_OK
+                     && sqlite3_prepare_v2(db, completeSql, -1, &completeStmt, nullptr) == SQLITE_OK;
+        if (!prepared) {
+            std::cerr << "Erro ao preparar rotina de juros: " << sqlite3_errmsg(db) << std::endl;
+        }
+
+        bool success = prepared;
+        while (success) {
+            if (!executeSql("BEGIN IMMEDIATE;")) {
+                success = false;
+                break;
+            }
+
+            sqlite3_reset(boundStmt);
+            sqlite3_bind_int64(boundStmt, 1, lastId);
+            sqlite3_bind_int(boundStmt, 2, chunkSize);
+            bool hasChunk = sqlite3_step(boundStmt) == SQLITE_ROW && sqlite3_column_type(boundStmt, 0) != SQLITE_NULL;
+            sqlite3_int64 upperId = hasChunk ? sqlite3_column_int64(boundStmt, 0) : lastId;
+
+            if (!hasChunk) {
+                sqlite3_reset(completeStmt);
+                sqlite3_bind_text(completeStmt, 1, accrualDate.c_str(), -1, SQLITE_TRANSIENT);
+                success = sqlite3_step(completeStmt) == SQLITE_DONE && commit();
+                break;
+            }
+
+            sqlite3_stmt* chunkStmts[] = {insertStmt, applyStmt, progressStmt};
+            for (sqlite3_stmt* stmt : chunkStmts) {
+                sqlite3_reset(stmt);
+                sqlite3_bind_text(stmt, 1, accrualDate.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(stmt, 2, lastId);
+                sqlite3_bind_int64(stmt, 3, upperId);
+                if (sqlite3_step(stmt) != SQLITE_DONE) {
+                    std::cerr << "Erro na rotina de juros: " << sqlite3_errmsg(db) << std::endl;
+                    success = false;
+                    break;
+                }
+            }
+
+            if (!success || !commit()) {
+                success = false;
+                break;
+            }
+            lastId = upperId;
+            result.chunks++;
+        }
+        if (!success) {
+            executeSql("ROLLBACK;");
+        }
+
+        sqlite3_finalize(boundStmt);
+        sqlite3_finalize(insertStmt);
+        sqlite3_finalize(applyStmt);
+        sqlite3_finalize(progressStmt);
+        sqlite3_finalize(completeStmt);
+        if (!success) return false;
+    } else {
+        result.alreadyCompleted = true;
+    }
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, totalsSql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, accrualDate.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            result.accounts = sqlite3_column_int(stmt, 0);
+            result.totalInterest = sqlite3_column_double(stmt, 1);
+        }
+    }
+    sqlite3_finalize(stmt);
+    // Um registo por execução que lançou blocos, com os totais do dia
+    if (result.chunks > 0) {
+        logActivity(ActivityType::InterestAccrued, 0, result.totalInterest, result.accounts);
+    }
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+double DatabaseManager::getCompanyInterestRate(const std::string& nipc) {
+    QueryTimer timer(QueryOp::GetCompanyInterestRate);
+    if (!isConnected) return 0.0;
+    const char* sql = "SELECT interest_rate FROM companies WHERE nipc = ?;";
+    sqlite3_stmt* stmt;
+    double rate = 0.0;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        bindNipc(stmt, 1, nipc);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            rate = sqlite3_column_double(stmt, 0);
+        }
+    }
+    sqlite3_finalize(stmt);
+    return rate;
+}
+
+bool DatabaseManager::scheduleInstallments(const std::string& nipc, const std::vector<Installment>& plan) {
+    QueryTimer timer(QueryOp::ScheduleInstallments);
+    if (!isConnected) return false;
+    if (plan.empty()) return true;
+
+    const char* sql = "INSERT INTO installments (company_id, number, due_date, amount, principal, interest) "
+                      "SELECT id, ?2, date('now', '+' || ?2 || ' months'), ?3, ?4, ?5 "
+                      "FROM companies WHERE nipc = ?1;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar plano de parcelas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    if (!executeSql("SAVEPOINT schedule_installments;")) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    bool success = true;
+    bindNipc(stmt, 1, nipc);
+    for (const auto& inst : plan) {
+        sqlite3_bind_int(stmt, 2, inst.number);
+        sqlite3_bind_double(stmt, 3, inst.value);
+        sqlite3_bind_double(stmt, 4, inst.principal);
+        sqlite3_bind_double(stmt, 5, inst.interest);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            std::cerr << "Erro ao gravar plano de parcelas: " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+            break;
+        }
+        if (sqlite3_changes(db) == 0) {
+            std::cerr << "Erro ao gravar plano de parcelas: empresa não encontrada" << std::endl;
+            success = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (!success) {
+        executeSql("ROLLBACK TO schedule_installments; RELEASE schedule_installments;");
+        return false;
+    }
+    if (!executeSql("RELEASE schedule_installments;")) return false;
+    double total = 0.0;
+    for (const auto& inst : plan) total += inst.value;
+    logActivity(ActivityType::InstallmentsPlanned, nipc, total, static_cast<int64_t>(plan.size()));
+    return true;
+}
+
+// Cobrança de parcelas.
+// Cada lote lê pelo índice parcial de vencimentos apenas parcelas em aberto, credita
+// os valores nos saldos (uma atualização por empresa) e marca as parcelas como pagas,
+// tudo na mesma transação. O custo acompanha o número de parcelas vencidas.
+bool DatabaseManager::collectDueInstallments(const std::string& asOfDate, CollectionResult& result, int batchSize) {
+    QueryTimer timer(QueryOp::CollectDueInstallments);
+    auto start = std::chrono::steady_clock::now();
+    result.asOfDate = asOfDate;
+    result.collected = 0;
+    result.batches = 0;
+    result.totalAmount = 0.0;
+    result.elapsedSeconds = 0.0;
+    if (!isConnected || batchSize <= 0) return false;
+    // due_date é comparado como texto: uma data mal escrita cobraria parcelas ainda não vencidas
+    if (!isIsoDate(asOfDate)) {
+        std::cerr << "Data de cobrança inválida (AAAA-MM-DD): " << asOfDate << std::endl;
+        return false;
+    }
+
+    if (!executeSql("CREATE TEMP TABLE IF NOT EXISTS collection_batch ("
+                    "id INTEGER PRIMARY KEY, company_id INTEGER NOT NULL, amount REAL NOT NULL);")) {
+        return false;
+    }
+
+    const char* selectSql = "INSERT INTO temp.collection_batch (id, company_id, amount) "
+                            "SELECT id, company_id, amount FROM installments "
+                            "WHERE paid = 0 AND due_date <= ?1 ORDER BY due_date, id LIMIT ?2;";
+    const char* totalSql = "SELECT COALESCE(SUM(amount), 0) FROM temp.collection_batch;";
+    const char* creditSql = "UPDATE companies SET balance = balance + b.total "
+                            "FROM (SELECT company_id, SUM(amount) AS total FROM temp.collection_batch "
+                            "GROUP BY company_id) AS b "
+                            "WHERE companies.id = b.company_id;";
+    const char* markSql = "UPDATE installments SET paid = 1, paid_at = ?1 "
+                          "WHERE id IN (SELECT id FROM temp.collection_batch);";
+
+    sqlite3_stmt* selectStmt = nullptr;
+    sqlite3_stmt* totalStmt = nullptr;
+    sqlite3_stmt* creditStmt = nullptr;
+    sqlite3_stmt* markStmt = nullptr;
+    bool success = sqlite3_prepare_v2(db, selectSql, -1, &selectStmt, nullptr) == SQLITE_OK
+                && sqlite3_prepare_v2(db, totalSql, -1, &totalStmt, nullptr) == SQLITE_OK
+                && sqlite3_prepare_v2(db, creditSql, -1, &creditStmt, nullptr) == SQLITE_OK
+                && sqlite3_prepare_v2(db, markSql, -1, &markStmt, nullptr) == SQLITE_OK;
+    if (!success) {
+        std::cerr << "Erro ao preparar cobrança de parcelas: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    while (success) {
+        if (!executeSql("BEGIN IMMEDIATE;") || !executeSql("DELETE FROM temp.collection_batch;")) {
+            success = false;
+            break;
+        }
+
+        sqlite3_reset(selectStmt);
+        sqlite3_bind_text(selectStmt, 1, asOfDate.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(selectStmt, 2, batchSize);
+        if (sqlite3_step(selectStmt) != SQLITE_DONE) {
+            success = false;
+            break;
+        }
+        int batchCount = sqlite3_changes(db);
+        if (batchCount == 0) {
+            success = commit();
+            break;
+        }
+
+        sqlite3_reset(totalStmt);
+        double batchAmount = sqlite3_step(totalStmt) == SQLITE_ROW ? sqlite3_column_double(totalStmt, 0) : 0.0;
+
+        sqlite3_reset(creditStmt);
+        sqlite3_reset(markStmt);
+        sqlite3_bind_int64(markStmt, 1, time(nullptr));
+        if (sqlite3_step(creditStmt) != SQLITE_DONE || sqlite3_step(markStmt) != SQLITE_DONE
+            || !commit()) {
+            success = false;
+            break;
+        }
+
+        result.collected += batchCount;
+        result.totalAmount += batchAmount;
+        result.batches++;
+        logActivity(ActivityType::InstallmentsCollected, 0, batchAmount, batchCount);
+    }
+    if (!success) {
+        std::cerr << "Erro na cobrança de parcelas: " << sqlite3_errmsg(db) << std::endl;
+        executeSql("ROLLBACK;");
+    }
+
+    sqlite3_finalize(selectStmt);
+    sqlite3_finalize(totalStmt);
+    sqlite3_finalize(creditStmt);
+    sqlite3_finalize(markStmt);
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return success;
+}
+
+// Condição das empresas a arquivar (alias c), sobre as tabelas do esquema indicado
+static std::string archivableCondition(const std::string& schema) {
+    return "(c.deleted = 1 OR (c.balance >= 0 "
+           "AND EXISTS (SELECT 1 FROM " + schema + ".installments i WHERE i.company_id = c.id) "
+           "AND NOT EXISTS (SELECT 1 FROM " + schema + ".installments i WHERE i.company_id = c.id AND i.paid = 0)))";
+}
+
+// Arquivamento de empresas.
+// O banco de arquivo é escrito por uma segunda conexão, que lê as linhas através de um
+// ATTACH do banco principal. Para cada bloco (intervalo de ids), a conexão principal abre
+// uma transação de escrita, o que impede alterações ao bloco por outros processos; a cópia
+// é gravada e confirmada no arquivo e só depois as linhas são apagadas do banco principal.
+// Uma interrupção entre os dois commits deixa as linhas nos dois bancos, e a execução
+// seguinte volta a copiá-las (INSERT OR REPLACE) antes de as apagar.
+bool DatabaseManager::archiveCompanies(const std::string& archivePath, ArchiveResult& result, int chunkSize) {
+    QueryTimer timer(QueryOp::ArchiveCompanies);
+    auto start = std::chrono::steady_clock::now();
+    result.archivePath = archivePath;
+    result.companies = 0;
+    result.tasks = 0;
+    result.installments = 0;
+    result.chunks = 0;
+    result.pagesFreed = 0;
+    result.elapsedSeconds = 0.0;
+    if (!isConnected || chunkSize <= 0) return false;
+    // A conexão do arquivo liga-se ao arquivo dbPath: com o banco em memória copiaria do
+    // disco e apagaria em memória, perdendo as linhas
+    if (options.inMemory) {
+        std::cerr << "O arquivamento não está disponível com o banco em memória (perfil memory)" << std::endl;
+        return false;
+    }
+
+    sqlite3* archiveDb = nullptr;
+    if (sqlite3_open(archivePath.c_str(), &archiveDb) != SQLITE_OK) {
+        std::cerr << "Erro ao abrir banco de arquivo: " << sqlite3_errmsg(archiveDb) << std::endl;
+        sqlite3_close(archiveDb);
+        return false;
+    }
+    sqlite3_busy_timeout(archiveDb, 5000);
+
+    const char* attachSql = "ATTACH DATABASE ?1 AS hot;";
+    const char* archiveSchemaSql = "CREATE TABLE IF NOT EXISTS companies ("
+                                   "id INTEGER PRIMARY KEY, name TEXT NOT NULL, nipc INTEGER NOT NULL, "
+                                   "location TEXT NOT NULL, employee_name TEXT NOT NULL, loan_amount REAL NOT NULL, "
+                                   "loan_approved INTEGER NOT NULL, balance REAL, created_at DATETIME, "
+                                   "deleted INTEGER NOT NULL, interest_rate REAL NOT NULL, archived_at INTEGER NOT NULL);"
+                                   "CREATE INDEX IF NOT EXISTS idx_archive_companies_nipc ON companies (nipc);"
+                                   "CREATE TABLE IF NOT EXISTS tasks ("
+                                   "id INTEGER PRIMARY KEY, description TEXT NOT NULL, completed INTEGER NOT NULL, "
+                                   "company_id INTEGER NOT NULL, created_at INTEGER NOT NULL, completed_at INTEGER);"
+                                   "CREATE TABLE IF NOT EXISTS installments ("
+                                   "id INTEGER PRIMARY KEY, company_id INTEGER NOT NULL, number INTEGER NOT NULL, "
+                                   "due_date TEXT NOT NULL, amount REAL NOT NULL, principal REAL NOT NULL, "
+                                   "interest REAL NOT NULL, paid INTEGER NOT NULL, paid_at INTEGER);";
+
+    // Cópias, na conexão do arquivo (?1 e ?2 delimitam o bloco de ids)
+    std::string hotChunk = "FROM hot.companies c WHERE c.id > ?1 AND c.id <= ?2 AND " + archivableCondition("hot");
+    std::string copyCompaniesSql = "INSERT OR REPLACE INTO main.companies SELECT c.id, c.name, c.nipc, c.location, "
+                                   "c.employee_name, c.loan_amount, c.loan_approved, c.balance, c.created_at, "
+                                   "c.deleted, c.interest_rate, ?3 " + hotChunk + ";";
+    std::string copyTasksSql = "INSERT OR REPLACE INTO main.tasks SELECT t.id, t.description, t.completed, "
+                               "t.company_id, t.created_at, t.completed_at FROM hot.tasks t "
+                               "WHERE t.company_id IN (SELECT c.id " + hotChunk + ");";
+    std::string copyInstallmentsSql = "INSERT OR REPLACE INTO main.installments SELECT i.id, i.company_id, i.number, "
+                                      "i.due_date, i.amount, i.principal, i.interest, i.paid, i.paid_at "
+                                      "FROM hot.installments i WHERE i.company_id IN (SELECT c.id " + hotChunk + ");";
+
+    // Seleção e remoção, na conexão principal
+    std::string boundSql = "SELECT MAX(id) FROM (SELECT c.id FROM main.companies c WHERE c.id > ?1 AND "
+                           + archivableCondition("main") + " ORDER BY c.id LIMIT ?2);";
+    std::string batchSql = "INSERT INTO temp.archive_batch (id) SELECT c.id FROM main.companies c "
+                           "WHERE c.id > ?1 AND c.id <= ?2 AND " + archivableCondition("main") + ";";
+    const char* deleteSql = "DELETE FROM main.tasks WHERE company_id IN (SELECT id FROM temp.archive_batch);"
+                            "DELETE FROM main.installments WHERE company_id IN (SELECT id FROM temp.archive_batch);"
+                            "DELETE FROM main.companies WHERE id IN (SELECT id FROM temp.archive_batch);";
+
+    bool success = executeSql("CREATE TEMP TABLE IF NOT EXISTS archive_batch ("
+                              "id INTEGER PRIMARY KEY);");
+    char* errMsg = nullptr;
+    if (success && sqlite3_exec(archiveDb, archiveSchemaSql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erro ao criar tabelas de arquivo: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        success = false;
+    }
+
+    sqlite3_stmt* attachStmt = nullptr;
+    if (success) {
+        success = sqlite3_prepare_v2(archiveDb, attachSql, -1, &attachStmt, nullptr) == SQLITE_OK;
+        if (success) {
+            sqlite3_bind_text(attachStmt, 1, dbPath.c_str(), -1, SQLITE_STATIC);
+            success = sqlite3_step(attachStmt) == SQLITE_DONE;
+        }
+        sqlite3_finalize(attachStmt);
+        if (!success) {
+            std::cerr << "Erro ao ligar banco de arquivo: " << sqlite3_errmsg(archiveDb) << std::endl;
+        }
+    }
+
+    sqlite3_stmt* boundStmt = nullptr;
+    sqlite3_stmt* batchStmt = nullptr;
+    sqlite3_stmt* copyStmts[3] = {nullptr, nullptr, nullptr};
+    if (success) {
+        success = sqlite3_prepare_v2(db, boundSql.c_str(), -1, &boundStmt, nullptr) == SQLITE_OK
+               && sqlite3_prepare_v2(db, batchSql.c_str(), -1, &batchStmt, nullptr) == SQLITE_OK;
+        if (!success) {
+            std::cerr << "Erro ao preparar arquivamento: " << sqlite3_errmsg(db) << std::endl;
+        }
+    }
+    if (success) {
+        success = sqlite3_prepare_v2(archiveDb, copyCompaniesSql.c_str(), -1, &copyStmts[0], nullptr) == SQLITE_OK
+               && sqlite3_prepare_v2(archiveDb, copyTasksSql.c_str(), -1, &copyStmts[1], nullptr) == SQLITE_OK
+               && sqlite3_prepare_v2(archiveDb, copyInstallmentsSql.c_str(), -1, &copyStmts[2], nullptr) == SQLITE_OK;
+        if (!success) {
+            std::cerr << "Erro ao preparar cópia para o arquivo: " << sqlite3_errmsg(archiveDb) << std::endl;
+        }
+    }
+
+    sqlite3_int64 lastId = 0;
+    while (success) {
+        if (!executeSql("BEGIN IMMEDIATE;") || !executeSql("DELETE FROM temp.archive_batch;")) {
+            success = false;
+            break;
+        }
+
+        sqlite3_reset(boundStmt);
+        sqlite3_bind_int64(boundStmt, 1, lastId);
+        sqlite3_bind_int(boundStmt, 2, chunkSize);
+        bool hasChunk = sqlite3_step(boundStmt) == SQLITE_ROW && sqlite3_column_type(boundStmt, 0) != SQLITE_NULL;
+        sqlite3_int64 upperId = hasChunk ? sqlite3_column_int64(boundStmt, 0) : lastId;
+        sqlite3_reset(boundStmt);
+        if (!hasChunk) {
+            success = commit();
+            break;
+        }
+
+        sqlite3_reset(batchStmt);
+        sqlite3_bind_int64(batchStmt, 1, lastId);
+        sqlite3_bind_int64(batchStmt, 2, upperId);
+        if (sqlite3_step(batchStmt) != SQLITE_DONE) {
+            success = false;
+            break;
+        }
+
+        // Cópia confirmada no arquivo antes de qualquer remoção
+        int copied[3] = {0, 0, 0};
+        success = sqlite3_exec(archiveDb, "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK;
+        for (int i = 0; success && i < 3; i++) {
+            sqlite3_reset(copyStmts[i]);
+            sqlite3_bind_int64(copyStmts[i], 1, lastId);
+            sqlite3_bind_int64(copyStmts[i], 2, upperId);
+            if (i == 0) sqlite3_bind_int64(copyStmts[i], 3, time(nullptr));
+            success = sqlite3_step(copyStmts[i]) == SQLITE_DONE;
+            copied[i] = sqlite3_changes(archiveDb);
+            sqlite3_reset(copyStmts[i]);
+        }
+        if (!success || sqlite3_exec(archiveDb, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::cerr << "Erro ao copiar para o arquivo: " << sqlite3_errmsg(archiveDb) << std::endl;
+            sqlite3_exec(archiveDb, "ROLLBACK;", nullptr, nullptr, nullptr);
+            success = false;
+            break;
+        }
+
+        if (!executeSql(deleteSql) || !commit()) {
+            success = false;
+            break;
+        }
+        lastId = upperId;
+        result.companies += copied[0];
+        result.tasks += copied[1];
+        result.installments += copied[2];
+        result.chunks++;
+    }
+    if (!success) {
+        std::cerr << "Arquivamento interrompido: " << sqlite3_errmsg(db) << std::endl;
+        executeSql("ROLLBACK;");
+    }
+
+    sqlite3_finalize(boundStmt);
+    sqlite3_finalize(batchStmt);
+    for (sqlite3_stmt* stmt : copyStmts) sqlite3_finalize(stmt);
+    sqlite3_close(archiveDb);
+    executeSql("DROP TABLE IF EXISTS temp.archive_batch;");
+
+    // Devolve as páginas livres ao sistema. Bancos criados antes do vacuum incremental
+    // são convertidos uma vez com um VACUUM completo.
+    if (success && result.companies > 0) {
+        auto pragmaInt = [this](const char* sql) {
+            sqlite3_stmt* stmt;
+            long long value = 0;
+            if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+                value = sqlite3_column_int64(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+            return value;
+        };
+        long long pagesBefore = pragmaInt("PRAGMA page_count;");
+        long long autoVacuum = pragmaInt("PRAGMA auto_vacuum;");
+        if (autoVacuum == 0) {
+            success = executeSql("PRAGMA auto_vacuum = INCREMENTAL; VACUUM;");
+        } else if (autoVacuum == 2) {
+            success = executeSql("PRAGMA incremental_vacuum;");
+        }
+        executeSql("PRAGMA wal_checkpoint(TRUNCATE);");
+        result.pagesFreed = pagesBefore - pragmaInt("PRAGMA page_count;");
+    }
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return success;
+}
+
+bool DatabaseManager::enableConcurrentAccess(int busyTimeoutMs) {
+    if (!isConnected) return false;
+    // O perfil pode pedir uma espera maior (rotinas batch)
+    setBusyTimeout(std::max(busyTimeoutMs, options.busyTimeoutMs));
+    return executeSql("PRAGMA journal_mode = WAL;");
+}
+
+bool DatabaseManager::beginTransaction() {
+    if (!isConnected) return false;
+    return executeSql("BEGIN IMMEDIATE;");
+}
+
+bool DatabaseManager::commitTransaction() {
+    if (!isConnected) return false;
+    return commit();
+}
+
+bool DatabaseManager::rollbackTransaction() {
+    if (!isConnected) return false;
+    return executeSql("ROLLBACK;");
+}
+
+bool DatabaseManager::savepoint(const std::string& name) {
+    if (!isConnected) return false;
+    if (!executeSql(("SAVEPOINT " + name + ";").c_str())) return false;
+    savepointMarks.push_back(pendingActivity.size());
+    return true;
+}
+
+bool DatabaseManager::releaseSavepoint(const std::string& name) {
+    if (!isConnected) return false;
+    if (!executeSql(("RELEASE " + name + ";").c_str())) return false;
+    if (!savepointMarks.empty()) savepointMarks.pop_back();
+    // Sem transação exterior, o RELEASE é o commit
+    publishActivity();
+    return true;
+}
+
+bool DatabaseManager::rollbackToSavepoint(const std::string& name) {
+    if (!isConnected) return false;
+    // O ROLLBACK TO não chama o hook de rollback: os registos do savepoint saem aqui
+    if (!savepointMarks.empty()) {
+        pendingActivity.resize(std::min(pendingActivity.size(), savepointMarks.back()));
+        savepointMarks.pop_back();
+    }
+    return executeSql(("ROLLBACK TO " + name + "; RELEASE " + name + ";").c_str());
+}
+
+void DatabaseManager::logActivity(ActivityType type, int64_t nipc, double amount, int64_t reference, uint16_t flags) {
+    ActivityLog& log = ActivityLog::instance();
+    if (!log.isOpen()) return;
+    if (sqlite3_get_autocommit(db)) {
+        publishActivity();
+        log.record(type, nipc, amount, reference, flags);
+        return;
+    }
+    pendingActivity.push_back({type, nipc, amount, reference, flags});
+}
+
+void DatabaseManager::logActivity(ActivityType type, const std::string& nipc, double amount, int64_t reference,
+                                  uint16_t flags) {
+    if (!ActivityLog::instance().isOpen()) return;
+    long long value;
+    logActivity(type, parseNipc(nipc, value) ? value : 0, amount, reference, flags);
+}
+
+// Os registos pendentes só saem da lista no commit ou no rollback (pelo hook); se a
+// conexão já não está numa transação e ainda os há, a transação foi gravada
+void DatabaseManager::publishActivity() {
+    if (pendingActivity.empty() || !sqlite3_get_autocommit(db)) return;
+    ActivityLog& log = ActivityLog::instance();
+    for (const PendingActivity& pending : pendingActivity) {
+        log.record(pending.type, pending.nipc, pending.amount, pending.reference, pending.flags);
+    }
+    pendingActivity.clear();
+    savepointMarks.clear();
+}
+
+void DatabaseManager::discardActivity(void* manager) {
+    DatabaseManager* self = static_cast<DatabaseManager*>(manager);
+    self->pendingActivity.clear();
+    self->savepointMarks.clear();
+}
@@ -1,30 +1,86 @@
 #ifndef DATABASE_MANAGER_H
 #define DATABASE_MANAGER_H
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sqlite3.h>
+#include "ActivityLog.h"
+#include "DatabaseOptions.h"
 #include "../models/Company.h"
 #include "../models/Task.h"
+#include "../models/Installment.h"
+#include "../models/Report.h"
+#include "../models/ResultSet.h"
 
 class DatabaseManager {
 private:
     sqlite3* db;
     bool isConnected;
     std::string dbPath;
+    bool schemaInitialized;
+    DatabaseOptions options;
+    std::string settings;
+    // Gravação periódica do modo em memória
+    std::thread persistThread;
+    std::mutex persistMutex;
+    std::condition_variable persistWake;
+    bool stopPersisting;
+    // Espera máxima por um lock (SQLITE_BUSY), usada por busyWait
+    int busyLimitMs;
+    // Registos de atividade da transação em curso, entregues ao ActivityLog no commit;
+    // savepointMarks guarda, por savepoint aberto, quantos registos havia antes dele
+    struct PendingActivity {
+        ActivityType type;
+        int64_t nipc;
+        double amount;
+        int64_t reference;
+        uint16_t flags;
+    };
+    std::vector<PendingActivity> pendingActivity;
+    std::vector<size_t> savepointMarks;
 
+    bool applyOptions();
+    void setBusyTimeout(int milliseconds);
+    bool loadFromDisk();
+    bool copyToDisk(const std::string& path);
+    void persistLoop();
+    bool commit();
     bool createTables();
     bool initializeDatabase();
+    int schemaVersion();
     bool migrateCnpjToNipc();
+    bool migrateInterestRate();
+    bool migrateCompanyKeys();
+    bool hasColumn(const char* table, const char* column);
+    bool isIsoDate(const std::string& text);
+    bool ensureLoanRollups();
+    bool executeSql(const char* sql);
+    bool changeBalance(const std::string& nipc, double amount);
+    // Regista uma operação já executada: fora de uma transação segue logo para o
+    // ActivityLog, dentro dela fica pendente até ao commit
+    void logActivity(ActivityType type, int64_t nipc, double amount, int64_t reference = 0, uint16_t flags = 0);
+    void logActivity(ActivityType type, const std::string& nipc, double amount, int64_t reference = 0, uint16_t flags = 0);
+    // Entrega os registos pendentes se a transação já terminou com sucesso
+    void publishActivity();
+    // Hook de rollback do SQLite: a transação foi desfeita, os registos pendentes também
+    static void discardActivity(void* manager);
+    bool resolveTaskNipcs(TaskResultSet& result, const std::vector<sqlite3_int64>& companyIds);
 
 public:
+    // Usa as opções por omissão do processo (defaultDatabaseOptions)
     DatabaseManager(const std::string& dbPath);
+    DatabaseManager(const std::string& dbPath, const DatabaseOptions& options);
     ~DatabaseManager();
     
     // Funções de gerenciamento de empresas
     bool createCompany(const Company& company);
     bool deleteCompany(const std::string& name);
     std::vector<Company> getAllCompanies();
+    // Preenche result (que é limpo antes) numa arena própria; devolve false em caso de erro
+    bool getAllCompanies(CompanyResultSet& result);
     Company getCompany(const std::string& nipc);
     bool updateCompanyBalance(const std::string& nipc, double amount);
     double getCompanyBalance(const std::string& nipc);
@@ -35,6 +91,8 @@ public:
     bool updateTaskStatus(int taskId, bool completed);
     std::vector<Task> getCompanyTasks(const std::string& companyNipc);
     std::vector<Task> getAllTasks();
+    bool getCompanyTasks(const std::string& companyNipc, TaskResultSet& result);
+    bool getAllTasks(TaskResultSet& result);
     
     // Autenticação de usuário
     bool authenticateUser(const std::string& username, const std::string& password);
@@ -47,8 +105,67 @@ public:
     double getTotalRecebido();
     double getSaldoGeral();
     std::vector<Company> getEmpresasInadimplentes();
+    TrendReport getTrendReport();
+    // Originação mensal entre duas datas (AAAA-MM-DD, inclusivas), lida das tabelas de agregados.
+    // Falha se alguma data for inválida ou o período estiver invertido.
+    bool getOriginationReport(const std::string& fromDate, const std::string& toDate,
+                              std::vector<OriginationBucket>& buckets);
+    bool rebuildLoanRollups();
     
+    // Novo empréstimo para uma empresa já cadastrada (debita o saldo e contabiliza a originação)
+    bool addLoanToCompany(const std::string& nipc, double amount);
+    
+    // Juros
+    bool setCompanyInterestRate(const std::string& nipc, double annualRate);
+    double getCompanyInterestRate(const std::string& nipc);
+    // Lança os juros diários de uma data (AAAA-MM-DD) sobre todos os saldos devedores.
+    // Processa as empresas em blocos de chunkSize, cada um numa transação, e pode
+    // ser executada várias vezes para a mesma data sem lançar juros em dobro.
+    // Uma data que não seja um dia válido no formato AAAA-MM-DD é recusada.
+    bool accrueInterest(const std::string& accrualDate, AccrualResult& result, int chunkSize = 50000);
+    
+    // Parcelas
+    // Grava o plano de parcelas de um empréstimo; a parcela n vence n meses após hoje
+    bool scheduleInstallments(const std::string& nipc, const std::vector<Installment>& plan);
+    // Cobra as parcelas vencidas até asOfDate (AAAA-MM-DD), em lotes de batchSize por transação.
+    // Parcelas cobradas ficam marcadas, pelo que uma execução interrompida pode ser repetida.
+    bool collectDueInstallments(const std::string& asOfDate, CollectionResult& result, int batchSize = 10000);
+    
+    // Arquivamento
+    // Move as empresas removidas e as quitadas (todas as parcelas pagas e saldo não devedor),
+    // com as suas tarefas e parcelas, para o banco archivePath, em blocos de chunkSize empresas.
+    // No fim devolve ao sistema as páginas libertadas (vacuum incremental). Recusado com o
+    // banco em memória.
+    bool archiveCompanies(const std::string& archivePath, ArchiveResult& result, int chunkSize = 1000);
+    
+    // Modo WAL com espera por locks, para vários processos ou conexões no mesmo arquivo
+    // (um escritor e vários leitores em simultâneo)
+    bool enableConcurrentAccess(int busyTimeoutMs = 5000);
+    
+    // Transação explícita para agrupar várias operações (modo batch). Operações que
+    // abrem a sua própria transação usam savepoints e passam a fazer parte desta.
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+    // Savepoint com nome: dentro de uma transação permite desfazer só uma parte dela;
+    // fora de uma transação abre uma, gravada quando o savepoint é libertado
+    bool savepoint(const std::string& name);
+    bool releaseSavepoint(const std::string& name);
+    // Desfaz tudo o que foi feito desde o savepoint e liberta-o
+    bool rollbackToSavepoint(const std::string& name);
+    
+    // Modo em memória: grava o conteúdo atual no arquivo de origem (ou em path), numa só
+    // transação do arquivo. Falha se houver uma transação explícita em curso.
+    bool persist();
+    bool persistTo(const std::string& path);
+    bool isInMemory() const { return options.inMemory; }
+
     bool isConnectedToDatabase() const { return isConnected; }
+    const DatabaseOptions& databaseOptions() const { return options; }
+    // Perfil e pragmas em vigor, lidos do SQLite depois de aplicados
+    const std::string& databaseSettings() const { return settings; }
+    // Verdadeiro se esta instância criou ou atualizou o esquema (primeira abertura do banco)
+    bool wasSchemaInitialized() const { return schemaInitialized; }
 };
 
 #endif // DATABASE_MANAGER_H 
\ No newline at end of file
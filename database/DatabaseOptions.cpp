@@ -0,0 +1,65 @@
+#include "DatabaseOptions.h"
+
+namespace {
+
+DatabaseOptions& processDefaults() {
+    static DatabaseOptions options;
+    return options;
+}
+
+} // namespace
+
+bool databaseProfile(const std::string& name, DatabaseOptions& options) {
+    DatabaseOptions profile;
+    profile.profile = name;
+    if (name == "default") {
+        // Sem alterações
+    } else if (name == "teller") {
+        profile.journalMode = "WAL";
+        profile.synchronous = "FULL";
+        profile.cacheSizeKiB = 16 * 1024;
+        profile.mmapSizeBytes = 256LL * 1024 * 1024;
+        profile.tempStore = "MEMORY";
+        profile.walAutocheckpointPages = 1000;
+        profile.busyTimeoutMs = 5000;
+    } else if (name == "batch") {
+        profile.journalMode = "WAL";
+        profile.synchronous = "NORMAL";
+        profile.cacheSizeKiB = 256 * 1024;
+        profile.mmapSizeBytes = 1024LL * 1024 * 1024;
+        profile.tempStore = "MEMORY";
+        profile.walAutocheckpointPages = 10000;
+        profile.busyTimeoutMs = 30000;
+    } else if (name == "memory") {
+        profile.inMemory = true;
+        profile.tempStore = "MEMORY";
+    } else {
+        return false;
+    }
+    options = profile;
+    return true;
+}
+
+const char* databaseProfileNames() {
+    return "default, teller, batch, memory";
+}
+
+DatabaseOptions readOnlyDatabaseOptions(bool immutable) {
+    DatabaseOptions options;
+    options.profile = immutable ? "snapshot" : "readonly";
+    options.cacheSizeKiB = 64 * 1024;
+    options.mmapSizeBytes = 1024LL * 1024 * 1024;
+    options.tempStore = "MEMORY";
+    options.busyTimeoutMs = 5000;
+    options.readOnly = true;
+    options.immutable = immutable;
+    return options;
+}
+
+const DatabaseOptions& defaultDatabaseOptions() {
+    return processDefaults();
+}
+
+void setDefaultDatabaseOptions(const DatabaseOptions& options) {
+    processDefaults() = options;
+}
@@ -0,0 +1,51 @@
+#ifndef DATABASE_OPTIONS_H
+#define DATABASE_OPTIONS_H
+
+#include <string>
+
+// Pragmas aplicados pelo DatabaseManager ao abrir a conexão. Campos vazios ou a zero
+// mantêm o valor do SQLite (ou, no caso do journal_mode, o modo já gravado no arquivo).
+struct DatabaseOptions {
+    std::string profile = "default";
+    std::string journalMode;        // DELETE, WAL, ...
+    std::string synchronous;        // OFF, NORMAL, FULL
+    int cacheSizeKiB = 0;
+    long long mmapSizeBytes = 0;
+    std::string tempStore;          // FILE ou MEMORY
+    int walAutocheckpointPages = 0; // páginas no WAL que disparam um checkpoint
+    int busyTimeoutMs = 0;
+    // Conexão só de leitura (SQLITE_OPEN_READONLY): não cria tabelas, não migra e não
+    // muda o journal_mode; o banco tem de estar já na versão atual do esquema
+    bool readOnly = false;
+    // Só com readOnly: abre com immutable=1, sem locks nem leitura do WAL. Apenas para
+    // cópias (snapshots) que nenhum outro processo altera.
+    bool immutable = false;
+    // Banco em memória, copiado do arquivo ao abrir (sqlite3_backup). As escritas ficam só
+    // em memória até persist(); com persistIntervalSeconds > 0 o conteúdo é também gravado
+    // no arquivo a esse intervalo e ao fechar.
+    bool inMemory = false;
+    int persistIntervalSeconds = 0;
+};
+
+// Perfis com nome:
+//   default  pragmas do SQLite (journal em rollback, synchronous FULL)
+//   teller   postos de atendimento: WAL com synchronous FULL, cada operação confirmada
+//            sobrevive a uma falha de energia; cache e mmap moderados
+//   batch    rotinas noturnas: WAL com synchronous NORMAL (uma falha de energia pode
+//            perder os últimos commits, que as rotinas repetem ao correr de novo), cache e
+//            mmap grandes e checkpoints mais espaçados
+//   memory   simulações: cópia do banco em memória, descartada ao fechar
+// Devolve false se o nome não existir.
+bool databaseProfile(const std::string& name, DatabaseOptions& options);
+// Nomes aceites, para mensagens de uso
+const char* databaseProfileNames();
+
+// Conexão de leitura para relatórios e visualizadores, com mmap e cache grandes
+DatabaseOptions readOnlyDatabaseOptions(bool immutable = false);
+
+// Opções usadas pelo construtor DatabaseManager(dbPath); definidas uma vez no arranque,
+// para que todas as conexões do processo usem o mesmo perfil
+const DatabaseOptions& defaultDatabaseOptions();
+void setDefaultDatabaseOptions(const DatabaseOptions& options);
+
+#endif // DATABASE_OPTIONS_H
@@ -0,0 +1,189 @@
+#include "QueryStats.h"
+#include <fstream>
+#include <iomanip>
+
+namespace {
+    const char* kQueryOpNames[] = {
+        "openDatabase",
+        "createCompany",
+        "deleteCompany",
+        "getAllCompanies",
+        "getCompany",
+        "updateCompanyBalance",
+        "getCompanyBalance",
+        "addLoanToCompany",
+        "createTask",
+        "deleteTask",
+        "updateTaskStatus",
+        "getCompanyTasks",
+        "getAllTasks",
+        "authenticateUser",
+        "createUser",
+        "getCompanyByNipcOrName",
+        "getTotalEmprestado",
+        "getTotalRecebido",
+        "getSaldoGeral",
+        "getEmpresasInadimplentes",
+        "getTrendReport",
+        "getOriginationReport",
+        "rebuildLoanRollups",
+        "setCompanyInterestRate",
+        "getCompanyInterestRate",
+        "accrueInterest",
+        "scheduleInstallments",
+        "collectDueInstallments",
+        "archiveCompanies",
+        "commitTransaction",
+        "persistDatabase"
+    };
+    static_assert(sizeof(kQueryOpNames) / sizeof(kQueryOpNames[0]) == static_cast<size_t>(QueryOp::Count),
+                  "kQueryOpNames deve ter um nome por QueryOp");
+
+    int highestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+    }
+}
+
+const char* queryOpName(QueryOp op) {
+    return kQueryOpNames[static_cast<int>(op)];
+}
+
+// Valores abaixo de 16 ns têm intervalo próprio; acima disso, cada potência de 2
+// é dividida em 16 sub-intervalos iguais
+int LatencyHistogram::bucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < kSubBuckets) return static_cast<int>(nanoseconds);
+    int exponent = highestBit(nanoseconds);
+    int subBucket = static_cast<int>((nanoseconds >> (exponent - 4)) & (kSubBuckets - 1));
+    int index = (exponent - 3) * kSubBuckets + subBucket;
+    return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < kSubBuckets) return static_cast<uint64_t>(index);
+    int exponent = index / kSubBuckets + 3;
+    uint64_t subBucket = static_cast<uint64_t>(index % kSubBuckets);
+    return ((kSubBuckets + subBucket + 1) << (exponent - 4)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (nanoseconds > current && !max.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+    uint64_t samples = count();
+    if (samples == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(samples * percent / 100.0);
+    if (target >= samples) target = samples - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < maxNanoseconds() ? bound : maxNanoseconds();
+        }
+    }
+    return maxNanoseconds();
+}
+
+QueryStats& QueryStats::instance() {
+    static QueryStats stats;
+    return stats;
+}
+
+void QueryStats::setDatabaseSettings(const std::string& value) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    settings = value;
+}
+
+std::string QueryStats::databaseSettings() const {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    return settings;
+}
+
+void QueryStats::print(std::ostream& out) const {
+    if (startupNanoseconds() > 0) {
+        out << "Arranque do programa: " << std::fixed << std::setprecision(1)
+            << startupNanoseconds() / 1e6 << " ms\n";
+    }
+    std::string profile = databaseSettings();
+    if (!profile.empty()) {
+        out << "Perfil do banco: " << profile << "\n";
+        const LatencyHistogram& commits = histogram(QueryOp::CommitTransaction);
+        if (commits.count() > 0) {
+            out << "Commit: p50 " << std::fixed << std::setprecision(1) << commits.percentile(50) / 1000.0
+                << " µs, p99 " << commits.percentile(99) / 1000.0 << " µs (" << commits.count() << " commits)\n";
+        } else {
+            // Operações isoladas confirmam-se sozinhas; a latência delas já inclui o commit
+            out << "Commit: sem transações explícitas\n";
+        }
+    }
+    if (busyRetries() > 0) {
+        out << "Esperas por lock (SQLITE_BUSY): " << busyRetries() << "\n";
+    }
+    if (startupNanoseconds() > 0 || !profile.empty() || busyRetries() > 0) out << "\n";
+    out << std::left
+        << std::setw(26) << "Operação"
+        << std::right
+        << std::setw(10) << "Chamadas"
+        << std::setw(12) << "Média µs"
+        << std::setw(12) << "p50 µs"
+        << std::setw(12) << "p99 µs"
+        << std::setw(12) << "Máx µs"
+        << "\n";
+    out << std::string(84, '-') << "\n";
+
+    out << std::fixed << std::setprecision(1);
+    for (int i = 0; i < static_cast<int>(QueryOp::Count); i++) {
+        const LatencyHistogram& h = histograms[i];
+        if (h.count() == 0) continue;
+        out << std::left << std::setw(26) << kQueryOpNames[i]
+            << std::right
+            << std::setw(10) << h.count()
+            << std::setw(12) << h.sumNanoseconds() / 1000.0 / h.count()
+            << std::setw(12) << h.percentile(50) / 1000.0
+            << std::setw(12) << h.percentile(99) / 1000.0
+            << std::setw(12) << h.maxNanoseconds() / 1000.0
+            << "\n";
+    }
+}
+
+bool QueryStats::writeJson(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out << "{\n";
+    if (startupNanoseconds() > 0) {
+        out << "  \"startup_ns\": " << startupNanoseconds() << ",\n";
+    }
+    std::string profile = databaseSettings();
+    if (!profile.empty()) {
+        out << "  \"database_profile\": \"" << profile << "\",\n";
+    }
+    out << "  \"busy_retries\": " << busyRetries() << ",\n";
+    out << "  \"operations\": [\n";
+    bool first = true;
+    for (int i = 0; i < static_cast<int>(QueryOp::Count); i++) {
+        const LatencyHistogram& h = histograms[i];
+        if (h.count() == 0) continue;
+        out << (first ? "" : ",\n")
+            << "    {\"name\": \"" << kQueryOpNames[i] << "\""
+            << ", \"count\": " << h.count()
+            << ", \"total_ns\": " << h.sumNanoseconds()
+            << ", \"p50_ns\": " << h.percentile(50)
+            << ", \"p90_ns\": " << h.percentile(90)
+            << ", \"p99_ns\": " << h.percentile(99)
+            << ", \"p999_ns\": " << h.percentile(99.9)
+            << ", \"max_ns\": " << h.maxNanoseconds() << "}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
@@ -0,0 +1,133 @@
+#ifndef QUERY_STATS_H
+#define QUERY_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "../trace.h"
+
+// Operações do DatabaseManager medidas pelas estatísticas
+enum class QueryOp {
+    OpenDatabase,
+    CreateCompany,
+    DeleteCompany,
+    GetAllCompanies,
+    GetCompany,
+    UpdateCompanyBalance,
+    GetCompanyBalance,
+    AddLoanToCompany,
+    CreateTask,
+    DeleteTask,
+    UpdateTaskStatus,
+    GetCompanyTasks,
+    GetAllTasks,
+    AuthenticateUser,
+    CreateUser,
+    GetCompanyByNipcOrName,
+    GetTotalEmprestado,
+    GetTotalRecebido,
+    GetSaldoGeral,
+    GetEmpresasInadimplentes,
+    GetTrendReport,
+    GetOriginationReport,
+    RebuildLoanRollups,
+    SetCompanyInterestRate,
+    GetCompanyInterestRate,
+    AccrueInterest,
+    ScheduleInstallments,
+    CollectDueInstallments,
+    ArchiveCompanies,
+    CommitTransaction,
+    PersistDatabase,
+    Count
+};
+
+const char* queryOpName(QueryOp op);
+
+// Histograma de latências em escala log-linear (estilo HDR): 16 sub-intervalos por
+// potência de 2, o que dá cerca de 6% de precisão de 1 ns a ~18 minutos.
+// Todos os contadores são atómicos; registar uma amostra não usa locks.
+class LatencyHistogram {
+public:
+    static const int kSubBuckets = 16;
+    static const int kBucketCount = 38 * kSubBuckets;
+
+    void record(uint64_t nanoseconds);
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t sumNanoseconds() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t maxNanoseconds() const { return max.load(std::memory_order_relaxed); }
+    // Limite superior do intervalo que contém o percentil pedido (0-100)
+    uint64_t percentile(double percent) const;
+
+private:
+    static int bucketIndex(uint64_t nanoseconds);
+    static uint64_t bucketUpperBound(int index);
+
+    std::atomic<uint64_t> buckets[kBucketCount] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+// Estatísticas globais do processo, partilhadas por todas as instâncias do DatabaseManager
+class QueryStats {
+public:
+    static QueryStats& instance();
+
+    void record(QueryOp op, uint64_t nanoseconds) { histograms[static_cast<int>(op)].record(nanoseconds); }
+    const LatencyHistogram& histogram(QueryOp op) const { return histograms[static_cast<int>(op)]; }
+
+    // Tempo desde o início do processo até o programa estar pronto a usar
+    void recordStartup(uint64_t nanoseconds) { startup.store(nanoseconds, std::memory_order_relaxed); }
+    uint64_t startupNanoseconds() const { return startup.load(std::memory_order_relaxed); }
+
+    // Perfil e pragmas da última conexão aberta (DatabaseManager::databaseSettings)
+    void setDatabaseSettings(const std::string& settings);
+    std::string databaseSettings() const;
+
+    // Novas tentativas depois de SQLITE_BUSY (cada espera do handler de locks conta uma)
+    void recordBusyRetry() { busyRetryCount.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t busyRetries() const { return busyRetryCount.load(std::memory_order_relaxed); }
+
+    void print(std::ostream& out) const;
+    bool writeJson(const std::string& path) const;
+
+private:
+    QueryStats() = default;
+    LatencyHistogram histograms[static_cast<int>(QueryOp::Count)];
+    std::atomic<uint64_t> startup{0};
+    std::atomic<uint64_t> busyRetryCount{0};
+    mutable std::mutex settingsMutex;
+    std::string settings;
+};
+
+// Mede o tempo de vida do objeto e regista-o na operação indicada
+// (com BANK_TRACE, também abre um span com o nome da operação)
+class QueryTimer {
+public:
+    explicit QueryTimer(QueryOp op)
+        : op(op),
+#ifdef BANK_TRACE
+          span(queryOpName(op)),
+#endif
+          start(std::chrono::steady_clock::now()) {}
+    ~QueryTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        QueryStats::instance().record(op, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    QueryTimer(const QueryTimer&) = delete;
+    QueryTimer& operator=(const QueryTimer&) = delete;
+
+private:
+    QueryOp op;
+#ifdef BANK_TRACE
+    trace::Span span;
+#endif
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // QUERY_STATS_H
@@ -23,8 +23,8 @@ void CompanyListWidget::refreshCompanies() {
 
 void CompanyListWidget::addCompanyToList(const Company& company) {
     QString displayText = QString("%1 - NIPC: %2 - Saldo: R$ %3")
-        .arg(QString::fromStdString(company.getName()))
-        .arg(QString::fromStdString(company.getNIPC()))
+        .arg(QString::fromStdString(std::string(company.getName())))
+        .arg(QString::fromStdString(std::string(company.getNIPC())))
         .arg(company.getBalance(), 0, 'f', 2);
 
     QListWidgetItem* item = new QListWidgetItem(displayText);
@@ -32,7 +32,7 @@ void CompanyListWidget::addCompanyToList(const Company& company) {
     item->setCheckState(Qt::Unchecked);
     
     // Armazena o NIPC como dados do item para referência
-    item->setData(Qt::UserRole, QString::fromStdString(company.getNIPC()));
+    item->setData(Qt::UserRole, QString::fromStdString(std::string(company.getNIPC())));
     
     addItem(item);
 }
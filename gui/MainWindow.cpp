@@ -93,14 +93,14 @@ void MainWindow::onDepositClicked() {
     
     DatabaseManager dbManager("database/bank.db");
     for (const auto& company : selectedCompanies) {
-        if (dbManager.updateCompanyBalance(company.getNIPC(), amount)) {
+        if (dbManager.updateCompanyBalance(std::string(company.getNIPC()), amount)) {
             QMessageBox::information(this, "Sucesso",
                 QString("Depósito realizado com sucesso para %1!")
-                .arg(QString::fromStdString(company.getName())));
+                .arg(QString::fromStdString(std::string(company.getName()))));
         } else {
             QMessageBox::warning(this, "Erro",
                 QString("Erro ao realizar depósito para %1!")
-                .arg(QString::fromStdString(company.getName())));
+                .arg(QString::fromStdString(std::string(company.getName()))));
         }
     }
     
@@ -117,9 +117,9 @@ void MainWindow::onCheckBalanceClicked() {
     DatabaseManager dbManager("database/bank.db");
     QString message;
     for (const auto& company : selectedCompanies) {
-        double balance = dbManager.getCompanyBalance(company.getNIPC());
+        double balance = dbManager.getCompanyBalance(std::string(company.getNIPC()));
         message += QString("%1 - Saldo: R$ %2\n")
-            .arg(QString::fromStdString(company.getName()))
+            .arg(QString::fromStdString(std::string(company.getName())))
             .arg(balance, 0, 'f', 2);
     }
     
@@ -140,7 +140,7 @@ void MainWindow::onAddTaskClicked() {
                                               "", &ok);
     if (!ok || description.isEmpty()) return;
     
-    taskList->addNewTask(description.toStdString(), selectedCompanies[0].getNIPC());
+    taskList->addNewTask(description.toStdString(), std::string(selectedCompanies[0].getNIPC()));
 }
 
 void MainWindow::onDeleteTaskClicked() {
@@ -172,7 +172,7 @@ void MainWindow::onToggleTaskClicked() {
 void MainWindow::onCompanySelected() {
     auto selectedCompanies = companyList->getSelectedCompanies();
     if (!selectedCompanies.empty()) {
-        taskList->refreshTasks(selectedCompanies[0].getNIPC());
+        taskList->refreshTasks(std::string(selectedCompanies[0].getNIPC()));
     } else {
         taskList->refreshTasks();
     }
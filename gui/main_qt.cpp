@@ -1,8 +1,10 @@
 #include <QApplication>
 #include "MainWindow.h"
+#include "../database/ActivityLog.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
+    ActivityLog::instance().open();
     
     MainWindow mainWindow;
     mainWindow.show();
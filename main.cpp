@@ -12,14 +12,27 @@
 #include <vector>
 #include <fstream>
 #include <limits>
+#include <ctime>
+#include <chrono>
+#include <filesystem>
+#include <cstdlib>
 #ifdef _WIN32
 #include <windows.h>
 #include <conio.h>
 #endif
+#include "database/ActivityLog.h"
 #include "database/DatabaseManager.h"
+#include "database/QueryStats.h"
 #include "models/Company.h"
+#include "models/Nipc.h"
 #include "advanced_features.h"
 #include "task_list.h"
+#include "batch_mode.h"
+#ifndef _WIN32
+#include "remote_menu.h"
+#endif
+#include "table_renderer.h"
+#include "trace.h"
 #include <sstream>
 #include <algorithm>
 
@@ -33,45 +46,46 @@ bool setupConsole() {
 #endif
 }
 
-void displayHeader() {
-    std::cout << std::left
-              << std::setw(30) << "Empresa"
-              << std::setw(20) << "NIPC"
-              << std::setw(20) << "Localização"
-              << std::setw(30) << "Funcionário"
-              << std::setw(15) << "Valor"
-              << std::setw(10) << "Status"
-              << std::setw(15) << "Saldo"
-              << "\n";
-    std::cout << std::string(135, '-') << "\n";
-}
+// Colunas da listagem de empresas
+const std::vector<TableColumn> kCompanyColumns = {
+    {"Empresa", 30, false},
+    {"NIPC", 20, false},
+    {"Localização", 20, false},
+    {"Funcionário", 30, false},
+    {"Valor", 15, false},
+    {"Status", 10, false},
+    {"Saldo", 15, false},
+};
 
-void displayCompany(const Company& company) {
-    std::cout << std::left
-              << std::setw(30) << company.getName()
-              << std::setw(20) << company.getNIPC()
-              << std::setw(20) << company.getLocation()
-              << std::setw(30) << company.getEmployeeName()
-              << std::setw(15) << std::fixed << std::setprecision(2) << company.getLoanAmount()
-              << std::setw(10) << (company.isLoanApproved() ? "Aprovado" : "Rejeitado")
-              << std::setw(15) << std::fixed << std::setprecision(2) << company.getBalance()
-              << "\n";
+template <typename Companies>
+void displayCompanies(const Companies& companies) {
+    TableRenderer table(kCompanyColumns, companies.size());
+    table.header();
+    for (const auto& company : companies) {
+        table.text(company.getName());
+        table.text(company.getNIPC());
+        table.text(company.getLocation());
+        table.text(company.getEmployeeName());
+        table.number(company.getLoanAmount());
+        table.text(company.isLoanApproved() ? "Aprovado" : "Rejeitado");
+        table.number(company.getBalance());
+        table.endRow();
+    }
+    table.finish();
 }
 
 void displayLog() {
     std::cout << "\n=== Log de Empréstimos ===\n\n";
     DatabaseManager dbManager("database/bank.db");
-    auto companies = dbManager.getAllCompanies();
+    CompanyResultSet companies;
+    dbManager.getAllCompanies(companies);
     
     if (companies.empty()) {
         std::cout << "Nenhum empréstimo registrado.\n";
         return;
     }
 
-    displayHeader();
-    for (const auto& company : companies) {
-        displayCompany(company);
-    }
+    displayCompanies(companies);
 }
 
 // Protótipo necessário para uso em addNewLoan
@@ -82,7 +96,22 @@ Company getCompanyByNipcOrName(DatabaseManager& dbManager, const std::string& in
     return dbManager.getCompanyByNipcOrName(input);
 }
 
+// Lê o número de parcelas de um empréstimo
+int readInstallmentCount() {
+    TRACE_SCOPE("readInstallmentCount");
+    int months;
+    std::cout << "Número de parcelas (1-360): ";
+    while (!(std::cin >> months) || months < 1 || months > 360) {
+        std::cout << "Valor inválido. Digite novamente: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cin.ignore();
+    return months;
+}
+
 void addNewLoan(DatabaseManager& dbManager) {
+    TRACE_SCOPE("addNewLoan");
     std::cout << "\n=== Novo Empréstimo ===\n\n";
     char jaCadastrada;
     std::cout << "A empresa já está cadastrada? (s/n): ";
@@ -97,6 +126,7 @@ void addNewLoan(DatabaseManager& dbManager) {
             std::cout << "\nEmpresa não encontrada!\n";
             return;
         }
+        std::string companyNipc(company.getNIPC());
         double novoEmprestimo;
         std::cout << "Valor do novo empréstimo: ";
         while (!(std::cin >> novoEmprestimo) || novoEmprestimo <= 0) {
@@ -105,10 +135,22 @@ void addNewLoan(DatabaseManager& dbManager) {
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
         std::cin.ignore();
-        // Subtrai o valor do novo empréstimo do saldo (fica mais negativo)
-        dbManager.updateCompanyBalance(company.getNIPC(), -novoEmprestimo);
+        int parcelas = readInstallmentCount();
+        // Débito do saldo (fica mais negativo) e plano de parcelas na mesma transação
+        bool success = dbManager.beginTransaction();
+        if (success) {
+            double taxa = dbManager.getCompanyInterestRate(companyNipc);
+            success = dbManager.addLoanToCompany(companyNipc, novoEmprestimo)
+                   && dbManager.scheduleInstallments(companyNipc, calculateInstallments(novoEmprestimo, taxa, parcelas))
+                   && dbManager.commitTransaction();
+            if (!success) dbManager.rollbackTransaction();
+        }
+        if (!success) {
+            std::cout << "\nErro ao registrar empréstimo; o saldo não foi alterado.\n";
+            return;
+        }
         std::cout << "\nNovo empréstimo registrado para a empresa!\n";
-        std::cout << "Novo saldo: R$ " << std::fixed << std::setprecision(2) << dbManager.getCompanyBalance(company.getNIPC()) << "\n";
+        std::cout << "Novo saldo: R$ " << std::fixed << std::setprecision(2) << dbManager.getCompanyBalance(companyNipc) << "\n";
         return;
     }
     // Fluxo normal para nova empresa
@@ -118,6 +160,12 @@ void addNewLoan(DatabaseManager& dbManager) {
     std::getline(std::cin, name);
     std::cout << "NIPC: ";
     std::getline(std::cin, nipc);
+    long long nipcValue;
+    if (!parseNipc(nipc, nipcValue) || !isValidNipc(nipcValue)) {
+        std::cout << "\nNIPC inválido: deve ter nove dígitos, o último de controlo.\n";
+        return;
+    }
+    nipc = formatNipc(nipcValue);
     // Verifica se a empresa já existe
     Company existingCompany = dbManager.getCompany(nipc);
     if (!existingCompany.getName().empty()) {
@@ -140,10 +188,23 @@ void addNewLoan(DatabaseManager& dbManager) {
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
     std::cin.ignore();
+    int months = readInstallmentCount();
     // Cria uma nova empresa e salva no banco de dados
     Company newCompany(name, nipc, location, employeeName, amount);
-    if (dbManager.createCompany(newCompany)) {
+    // Empresa nova: a taxa vem da análise de crédito, sem histórico
+    CreditAnalysis analysis = calculateCreditScore(newCompany, {});
+    // Empresa, taxa e plano de parcelas são gravados juntos ou não são gravados
+    bool success = dbManager.beginTransaction();
+    if (success) {
+        success = dbManager.createCompany(newCompany)
+               && dbManager.setCompanyInterestRate(nipc, analysis.interestRate)
+               && dbManager.scheduleInstallments(nipc, calculateInstallments(amount, analysis.interestRate, months))
+               && dbManager.commitTransaction();
+        if (!success) dbManager.rollbackTransaction();
+    }
+    if (success) {
         std::cout << "\nEmpréstimo registrado com sucesso!\n";
+        std::cout << "Taxa de juros: " << std::fixed << std::setprecision(2) << (analysis.interestRate * 100) << "% ao ano\n";
     } else {
         std::cout << "\nErro ao registrar empréstimo.\n";
     }
@@ -190,16 +251,6 @@ void depositMoney(DatabaseManager& dbManager) {
     }
 }
 
-// Função para criar tabela de usuários se não existir
-void createUsersTable(DatabaseManager& dbManager) {
-    sqlite3* db;
-    sqlite3_open("database/bank.db", &db);
-    const char* sql = "CREATE TABLE IF NOT EXISTS users (id INTEGER PRIMARY KEY AUTOINCREMENT, username TEXT UNIQUE, password TEXT);";
-    char* errMsg = nullptr;
-    sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
-    sqlite3_close(db);
-}
-
 // Função para criar usuário admin padrão
 void createDefaultAdmin(DatabaseManager& dbManager) {
     dbManager.createUser("admin", "senha123");
@@ -236,6 +287,7 @@ bool login(DatabaseManager& dbManager) {
 
 // Nova função para consultar saldo por NIPC ou nome
 void checkBalanceByNipcOrName(DatabaseManager& dbManager) {
+    TRACE_SCOPE("checkBalanceByNipcOrName");
     std::cout << "\n=== Consultar Saldo ===\n\n";
     std::string input;
     std::cout << "NIPC ou Nome da empresa: ";
@@ -250,6 +302,7 @@ void checkBalanceByNipcOrName(DatabaseManager& dbManager) {
 
 // Nova função para depósito por NIPC ou nome
 void depositMoneyByNipcOrName(DatabaseManager& dbManager) {
+    TRACE_SCOPE("depositMoneyByNipcOrName");
     std::cout << "\n=== Depositar Dinheiro ===\n\n";
     std::string input;
     double amount;
@@ -260,6 +313,7 @@ void depositMoneyByNipcOrName(DatabaseManager& dbManager) {
         std::cout << "\nEmpresa não encontrada!\n";
         return;
     }
+    std::string companyNipc(company.getNIPC());
     std::cout << "Valor a depositar: R$ ";
     while (!(std::cin >> amount) || amount <= 0) {
         std::cout << "Valor inválido. Digite novamente: ";
@@ -268,8 +322,8 @@ void depositMoneyByNipcOrName(DatabaseManager& dbManager) {
     }
     std::cin.ignore();
     // Soma o valor ao saldo
-    if (dbManager.updateCompanyBalance(company.getNIPC(), amount)) {
-        std::cout << "\nDepósito realizado com sucesso!\nNovo saldo: R$ " << std::fixed << std::setprecision(2) << dbManager.getCompanyBalance(company.getNIPC()) << "\n";
+    if (dbManager.updateCompanyBalance(companyNipc, amount)) {
+        std::cout << "\nDepósito realizado com sucesso!\nNovo saldo: R$ " << std::fixed << std::setprecision(2) << dbManager.getCompanyBalance(companyNipc) << "\n";
     } else {
         std::cout << "\nErro ao realizar depósito. Empresa não encontrada!\n";
     }
@@ -277,6 +331,7 @@ void depositMoneyByNipcOrName(DatabaseManager& dbManager) {
 
 // Nova função para pagamento por NIPC ou nome
 void paymentByNipcOrName(DatabaseManager& dbManager) {
+    TRACE_SCOPE("paymentByNipcOrName");
     std::cout << "\n=== Fazer Pagamento ===\n\n";
     std::string input;
     double amount;
@@ -287,6 +342,7 @@ void paymentByNipcOrName(DatabaseManager& dbManager) {
         std::cout << "\nEmpresa não encontrada!\n";
         return;
     }
+    std::string companyNipc(company.getNIPC());
     double saldo = company.getBalance();
     std::cout << "Saldo atual: R$ " << std::fixed << std::setprecision(2) << saldo << "\n";
     if (saldo >= 0) {
@@ -320,12 +376,12 @@ void paymentByNipcOrName(DatabaseManager& dbManager) {
     if (amount > maxPagamento) {
         amount = maxPagamento;
     }
-    if (dbManager.updateCompanyBalance(company.getNIPC(), amount)) {
-        double novoSaldo = dbManager.getCompanyBalance(company.getNIPC());
+    if (dbManager.updateCompanyBalance(companyNipc, amount)) {
+        double novoSaldo = dbManager.getCompanyBalance(companyNipc);
         // Se por algum motivo o saldo ficou positivo, ajusta para zero
         if (novoSaldo > 0.0) {
             double ajuste = -novoSaldo;
-            dbManager.updateCompanyBalance(company.getNIPC(), ajuste);
+            dbManager.updateCompanyBalance(companyNipc, ajuste);
             novoSaldo = 0.0;
         }
         std::cout << "\nPagamento realizado com sucesso!\nNovo saldo: R$ " << std::fixed << std::setprecision(2) << novoSaldo << "\n";
@@ -334,8 +390,22 @@ void paymentByNipcOrName(DatabaseManager& dbManager) {
     }
 }
 
+// Estatísticas de latência das operações do banco (opção oculta 99 do menu)
+const char* kQueryStatsPath = "database/query_stats.json";
+// Spans gravados ao sair quando compilado com BANK_TRACE
+const char* kTracePath = "database/trace.json";
+
+void showQueryStats() {
+    std::cout << "\n=== Estatísticas do Banco de Dados ===\n\n";
+    QueryStats::instance().print(std::cout);
+    if (QueryStats::instance().writeJson(kQueryStatsPath)) {
+        std::cout << "\nEstatísticas gravadas em " << kQueryStatsPath << "\n";
+    }
+}
+
 // Função para mostrar relatórios
 void showReports(DatabaseManager& dbManager) {
+    TRACE_SCOPE("showReports");
     int op;
     do {
         std::cout << "\n=== Relatórios ===\n";
@@ -356,29 +426,172 @@ void showReports(DatabaseManager& dbManager) {
             if (inadimplentes.empty()) {
                 std::cout << "Nenhuma empresa inadimplente.\n";
             } else {
-                displayHeader();
-                for (const auto& company : inadimplentes) {
-                    displayCompany(company);
-                }
+                displayCompanies(inadimplentes);
             }
         }
     } while (op != 0);
 }
 
-int main() {
+// Data atual no formato AAAA-MM-DD
+std::string todayIsoDate() {
+    char buffer[11];
+    time_t now = time(nullptr);
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", std::localtime(&now));
+    return buffer;
+}
+
+// Rotina de juros, executada sem menu nem login (linha de comando ou agendador):
+//   bank_system --accrue-interest [AAAA-MM-DD]
+int runInterestAccrual(DatabaseManager& dbManager, const std::string& accrualDate) {
+    TRACE_SCOPE("runInterestAccrual");
+    AccrualResult result;
+    if (!dbManager.accrueInterest(accrualDate, result)) {
+        std::cerr << "Erro ao lançar juros de " << accrualDate << "\n";
+        return 1;
+    }
+    if (result.alreadyCompleted) {
+        std::cout << "Juros de " << accrualDate << " já lançados anteriormente.\n";
+    } else {
+        std::cout << "Juros de " << accrualDate << " lançados em " << result.chunks << " blocos ("
+                  << std::fixed << std::setprecision(3) << result.elapsedSeconds << " s).\n";
+    }
+    std::cout << "Contas: " << result.accounts << "\n";
+    std::cout << "Total de juros: R$ " << std::fixed << std::setprecision(2) << -result.totalInterest << "\n";
+    return 0;
+}
+
+// Cobrança das parcelas vencidas, executada sem menu nem login:
+//   bank_system --collect-installments [AAAA-MM-DD]
+int runInstallmentCollection(DatabaseManager& dbManager, const std::string& asOfDate) {
+    TRACE_SCOPE("runInstallmentCollection");
+    CollectionResult result;
+    bool success = dbManager.collectDueInstallments(asOfDate, result);
+    std::cout << "Parcelas cobradas até " << asOfDate << ": " << result.collected
+              << " em " << result.batches << " lotes\n";
+    std::cout << "Total cobrado: R$ " << std::fixed << std::setprecision(2) << result.totalAmount << "\n";
+    std::cout << "Tempo: " << std::setprecision(3) << result.elapsedSeconds << " s";
+    if (result.elapsedSeconds > 0) {
+        std::cout << " (" << std::setprecision(0) << (result.collected / result.elapsedSeconds) << " parcelas/s)";
+    }
+    std::cout << "\n";
+    if (!success) {
+        std::cerr << "Cobrança interrompida; execute novamente para continuar.\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Arquivamento das empresas removidas e quitadas, executado sem menu nem login:
+//   bank_system --archive [database/archive.db]
+int runArchive(DatabaseManager& dbManager, const std::string& archivePath) {
+    TRACE_SCOPE("runArchive");
+    if (dbManager.isInMemory()) {
+        std::cerr << "O arquivamento não está disponível com --profile memory.\n";
+        return 1;
+    }
+    ArchiveResult result;
+    bool success = dbManager.archiveCompanies(archivePath, result);
+    std::cout << "Empresas arquivadas em " << archivePath << ": " << result.companies
+              << " em " << result.chunks << " blocos\n";
+    std::cout << "Tarefas: " << result.tasks << ", parcelas: " << result.installments << "\n";
+    std::cout << "Páginas libertadas: " << result.pagesFreed << "\n";
+    std::cout << "Tempo: " << std::fixed << std::setprecision(3) << result.elapsedSeconds << " s\n";
+    if (!success) {
+        std::cerr << "Arquivamento interrompido; execute novamente para continuar.\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Modo batch: comandos de um arquivo (ou da entrada padrão com "-"), resultados em JSON na saída padrão
+int runBatchMode(DatabaseManager& dbManager, const std::string& path) {
+    std::ios::sync_with_stdio(false);
+    if (path == "-") {
+        return runBatch(dbManager, std::cin, std::cout);
+    }
+    std::ifstream commands(path);
+    if (!commands.is_open()) {
+        std::cerr << "Erro ao abrir " << path << "\n";
+        return 1;
+    }
+    return runBatch(dbManager, commands, std::cout);
+}
+
+int main(int argc, char* argv[]) {
+    auto startupBegin = std::chrono::steady_clock::now();
     try {
         if (!setupConsole()) {
             std::cerr << "Erro ao configurar o console para UTF-8.\n";
             return 1;
         }
-        #ifdef _WIN32
-        system("if not exist database mkdir database");
-        #else
-        system("mkdir -p database");
-        #endif
+#ifndef _WIN32
+        // Cliente de um bank_daemon em execução: bank_system --daemon [database/bank.sock].
+        // O banco não é aberto neste processo.
+        if (argc > 1 && std::string(argv[1]) == "--daemon") {
+            return runRemoteMenu(argc > 2 ? argv[2] : "database/bank.sock");
+        }
+#endif
+        // Perfil de durabilidade antes do modo: bank_system --profile batch --accrue-interest
+        if (argc > 2 && std::string(argv[1]) == "--profile") {
+            DatabaseOptions options;
+            if (!databaseProfile(argv[2], options)) {
+                std::cerr << "Perfil desconhecido: " << argv[2] << " (" << databaseProfileNames() << ")\n";
+                return 1;
+            }
+            // Os argumentos seguintes passam a ser lidos a partir de argv[1]
+            argc -= 2;
+            argv += 2;
+            // Com o perfil memory, grava o banco no arquivo a cada N segundos e ao sair:
+            // bank_system --profile memory --persist-every 60 --batch cenario.txt
+            if (argc > 2 && std::string(argv[1]) == "--persist-every") {
+                int seconds = std::atoi(argv[2]);
+                if (!options.inMemory || seconds <= 0) {
+                    std::cerr << "--persist-every exige --profile memory e um intervalo em segundos maior que 0\n";
+                    return 1;
+                }
+                options.persistIntervalSeconds = seconds;
+                argc -= 2;
+                argv += 2;
+            }
+            setDefaultDatabaseOptions(options);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--persist-every") {
+            std::cerr << "--persist-every exige --profile memory antes dele\n";
+            return 1;
+        }
+        std::filesystem::create_directories("database");
+        // No perfil memory sem --persist-every as escritas são descartadas ao sair; não vão
+        // para o registo
+        if (!defaultDatabaseOptions().inMemory || defaultDatabaseOptions().persistIntervalSeconds > 0) {
+            ActivityLog::instance().open();
+        }
         DatabaseManager dbManager("database/bank.db");
-        createUsersTable(dbManager);
-        createDefaultAdmin(dbManager);
+        // A tabela users faz parte do esquema; o admin só é criado junto com o banco
+        if (dbManager.wasSchemaInitialized()) {
+            createDefaultAdmin(dbManager);
+        }
+        QueryStats::instance().recordStartup(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startupBegin).count()));
+        if (argc > 1 && std::string(argv[1]) == "--accrue-interest") {
+            int status = runInterestAccrual(dbManager, argc > 2 ? argv[2] : todayIsoDate());
+            TRACE_DUMP(kTracePath);
+            return status;
+        }
+        if (argc > 1 && std::string(argv[1]) == "--collect-installments") {
+            int status = runInstallmentCollection(dbManager, argc > 2 ? argv[2] : todayIsoDate());
+            TRACE_DUMP(kTracePath);
+            return status;
+        }
+        if (argc > 1 && std::string(argv[1]) == "--archive") {
+            int status = runArchive(dbManager, argc > 2 ? argv[2] : "database/archive.db");
+            TRACE_DUMP(kTracePath);
+            return status;
+        }
+        if (argc > 1 && std::string(argv[1]) == "--batch") {
+            int status = runBatchMode(dbManager, argc > 2 ? argv[2] : "-");
+            TRACE_DUMP(kTracePath);
+            return status;
+        }
         // Login antes do menu principal
         while (!login(dbManager)) {
             std::cout << "\nUsuário ou senha incorretos. Tente novamente.\n";
@@ -401,19 +614,17 @@ int main() {
             switch (choice) {
                 case 1: {
                     std::cout << "\n=== Histórico de Empréstimos ===\n\n";
-                    auto companies = dbManager.getAllCompanies();
+                    CompanyResultSet companies;
+                    dbManager.getAllCompanies(companies);
                     if (companies.empty()) {
                         std::cout << "Nenhum registro encontrado.\n";
                     } else {
-                        displayHeader();
-                        for (const auto& company : companies) {
-                            displayCompany(company);
-                        }
+                        displayCompanies(companies);
                     }
                     break;
                 }
                 case 2:
-                    showAdvancedMenu();
+                    showAdvancedMenu(dbManager);
                     break;
                 case 3:
                     addNewLoan(dbManager);
@@ -428,12 +639,17 @@ int main() {
                     paymentByNipcOrName(dbManager);
                     break;
                 case 7:
-                    taskManagement();
+                    taskManagement(dbManager);
                     break;
                 case 8:
                     showReports(dbManager);
                     break;
+                case 99:
+                    showQueryStats();
+                    break;
                 case 0:
+                    QueryStats::instance().writeJson(kQueryStatsPath);
+                    TRACE_DUMP(kTracePath);
                     std::cout << "\nSaindo do sistema...\n";
                     return 0;
                 default:
@@ -1,7 +1,42 @@
 #include "Company.h"
+#include <cstring>
+#include "StringPool.h"
 
-Company::Company(const std::string& name, const std::string& nipc, const std::string& location, 
-                const std::string& employeeName, double loanAmount)
-    : name(name), nipc(nipc), location(location), employeeName(employeeName), 
-      loanAmount(loanAmount), loanApproved(loanAmount <= 100000.0), balance(-loanAmount) {
-} 
\ No newline at end of file
+Company::Company(std::string_view name, std::string_view nipc, std::string_view location,
+                 std::string_view employeeName, double loanAmount)
+    : nipc(), nipcSize(0), loanApproved(loanAmount <= 100000.0),
+      locationId(StringPool::shared().intern(location)),
+      employeeId(StringPool::shared().intern(employeeName)),
+      loanAmount(loanAmount), balance(-loanAmount), name(name) {
+    setNipc(nipc);
+}
+
+void Company::setNipc(std::string_view value) {
+    if (value.size() <= kInlineNipc) {
+        if (!value.empty()) std::memcpy(nipc, value.data(), value.size());
+        nipcSize = static_cast<uint8_t>(value.size());
+        return;
+    }
+    uint32_t id = StringPool::shared().intern(value);
+    std::memcpy(nipc, &id, sizeof(id));
+    nipcSize = kPooledNipc;
+}
+
+std::string_view Company::getNIPC() const {
+    if (nipcSize != kPooledNipc) return std::string_view(nipc, nipcSize);
+    uint32_t id;
+    std::memcpy(&id, nipc, sizeof(id));
+    return StringPool::shared().lookup(id);
+}
+
+std::string_view Company::getName() const {
+    return name;
+}
+
+std::string_view Company::getLocation() const {
+    return StringPool::shared().lookup(locationId);
+}
+
+std::string_view Company::getEmployeeName() const {
+    return StringPool::shared().lookup(employeeId);
+}
@@ -1,34 +1,50 @@
 #ifndef COMPANY_H
 #define COMPANY_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+// Local e funcionário ficam internados no StringPool (só o id de 32 bits fica na empresa),
+// porque têm poucos valores distintos. O nome é quase sempre único e pertence à empresa,
+// tal como o NIPC (num buffer interno): internado, o pool cresceria com cada empresa lida
+// e nunca seria libertado. Os getters devolvem string_view; o texto do pool vive até ao
+// fim do programa, mas o do nome e do NIPC pertence à empresa e não deve ser guardado
+// para além dela.
 class Company {
 private:
-    std::string name;
-    std::string nipc;
-    std::string location;
-    std::string employeeName;
-    double loanAmount;
+    static const size_t kInlineNipc = 15;
+    // Valor de nipcSize para NIPCs maiores que o buffer, guardados no pool
+    static const uint8_t kPooledNipc = 0xFF;
+
+    char nipc[kInlineNipc];
+    uint8_t nipcSize;
     bool loanApproved;
+    uint32_t locationId;
+    uint32_t employeeId;
+    double loanAmount;
     double balance;
+    std::string name;
+
+    void setNipc(std::string_view value);
 
 public:
-    Company() : name(""), nipc(""), location(""), employeeName(""), loanAmount(0.0), loanApproved(true), balance(0.0) {}
+    Company() : nipc(), nipcSize(0), loanApproved(true), locationId(0), employeeId(0), loanAmount(0.0), balance(0.0) {}
     
-    Company(const std::string& name, const std::string& nipc, const std::string& location, 
-            const std::string& employeeName, double loanAmount);
+    Company(std::string_view name, std::string_view nipc, std::string_view location,
+            std::string_view employeeName, double loanAmount);
     
     // Getters
-    std::string getName() const { return name; }
-    std::string getNIPC() const { return nipc; }
-    std::string getLocation() const { return location; }
-    std::string getEmployeeName() const { return employeeName; }
+    std::string_view getName() const;
+    std::string_view getNIPC() const;
+    std::string_view getLocation() const;
+    std::string_view getEmployeeName() const;
     double getLoanAmount() const { return loanAmount; }
     bool isLoanApproved() const { return loanApproved; }
     double getBalance() const { return balance; }
     
     void setBalance(double newBalance) { balance = newBalance; }
+    void setLoanApproved(bool approved) { loanApproved = approved; }
 };
 
-#endif // COMPANY_H 
\ No newline at end of file
+#endif // COMPANY_H
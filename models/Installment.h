@@ -0,0 +1,13 @@
+#ifndef INSTALLMENT_H
+#define INSTALLMENT_H
+
+// Estrutura para parcelas
+struct Installment {
+    int number;
+    double value;
+    double principal;
+    double interest;
+    double remainingBalance;
+};
+
+#endif // INSTALLMENT_H
@@ -0,0 +1,49 @@
+#include "Nipc.h"
+
+namespace {
+
+const long long kMinNipc = 100000000;
+const long long kMaxNipc = 999999999;
+
+} // namespace
+
+bool parseNipc(std::string_view text, long long& value) {
+    long long result = 0;
+    int digits = 0;
+    for (char c : text) {
+        if (c == ' ') continue;
+        if (c < '0' || c > '9' || digits == kNipcDigits) return false;
+        result = result * 10 + (c - '0');
+        digits++;
+    }
+    if (digits != kNipcDigits || result < kMinNipc) return false;
+    value = result;
+    return true;
+}
+
+int nipcCheckDigit(long long firstDigits) {
+    int sum = 0;
+    for (int weight = 2; weight <= 9; weight++) {
+        sum += static_cast<int>(firstDigits % 10) * weight;
+        firstDigits /= 10;
+    }
+    int remainder = sum % 11;
+    return remainder < 2 ? 0 : 11 - remainder;
+}
+
+bool isValidNipc(long long value) {
+    return value >= kMinNipc && value <= kMaxNipc && nipcCheckDigit(value / 10) == value % 10;
+}
+
+void formatNipc(long long value, char* out) {
+    for (int i = kNipcDigits - 1; i >= 0; i--) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+std::string formatNipc(long long value) {
+    std::string text(kNipcDigits, '0');
+    formatNipc(value, &text[0]);
+    return text;
+}
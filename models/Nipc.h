@@ -0,0 +1,25 @@
+#ifndef NIPC_H
+#define NIPC_H
+
+#include <string>
+#include <string_view>
+
+// O NIPC tem nove dígitos, o último de controlo (módulo 11 sobre os oito primeiros, com
+// pesos 9 a 2). No banco é guardado como INTEGER; o texto só existe na interface, e estas
+// funções fazem a conversão nos dois sentidos.
+const int kNipcDigits = 9;
+
+// Lê um NIPC escrito pelo utilizador: nove dígitos, o primeiro diferente de zero, com
+// espaços opcionais ("501 234 567"). Não verifica o dígito de controlo, para que NIPCs
+// gravados antes da validação continuem a ser encontrados.
+bool parseNipc(std::string_view text, long long& value);
+
+// Dígito de controlo para os oito primeiros dígitos
+int nipcCheckDigit(long long firstDigits);
+bool isValidNipc(long long value);
+
+// Escreve os kNipcDigits dígitos em out, sem terminador
+void formatNipc(long long value, char* out);
+std::string formatNipc(long long value);
+
+#endif // NIPC_H
@@ -0,0 +1,66 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <string>
+#include <vector>
+
+// Empréstimos agregados por localização
+struct LocationSummary {
+    std::string location;
+    int loanCount;
+    double totalAmount;
+};
+
+// Estatísticas dos valores emprestados
+struct LoanAmountStats {
+    int loanCount;
+    double minAmount;
+    double maxAmount;
+    double averageAmount;
+};
+
+// Relatório de tendências, calculado pelo banco de dados
+struct TrendReport {
+    std::vector<LocationSummary> locations;
+    LoanAmountStats amounts;
+};
+
+// Originação de empréstimos num período (mês AAAA-MM ou dia AAAA-MM-DD)
+struct OriginationBucket {
+    std::string period;
+    int loanCount;
+    double loanVolume;
+    int defaultCount;
+};
+
+// Resultado de uma execução da rotina de juros
+struct AccrualResult {
+    std::string accrualDate;
+    int accounts;
+    int chunks;
+    double totalInterest;
+    double elapsedSeconds;
+    bool alreadyCompleted;
+};
+
+// Resultado de uma execução da cobrança de parcelas
+struct CollectionResult {
+    std::string asOfDate;
+    int collected;
+    int batches;
+    double totalAmount;
+    double elapsedSeconds;
+};
+
+// Resultado de uma execução do arquivamento de empresas
+struct ArchiveResult {
+    std::string archivePath;
+    int companies;
+    int tasks;
+    int installments;
+    int chunks;
+    long long pagesFreed;
+    double elapsedSeconds;
+};
+
+#endif // REPORT_H
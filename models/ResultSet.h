@@ -0,0 +1,92 @@
+#ifndef RESULT_SET_H
+#define RESULT_SET_H
+
+#include <cstring>
+#include <ctime>
+#include <memory_resource>
+#include <utility>
+#include <string_view>
+#include <vector>
+
+// Linha de uma listagem de empresas; o texto aponta para a arena do ResultSet que a contém.
+// Ao contrário de Company, nada passa pelo StringPool: o texto é libertado com a listagem.
+struct CompanyRow {
+    std::string_view name;
+    std::string_view nipc;
+    std::string_view location;
+    std::string_view employeeName;
+    double loanAmount;
+    double balance;
+    bool loanApproved;
+
+    std::string_view getName() const { return name; }
+    std::string_view getNIPC() const { return nipc; }
+    std::string_view getLocation() const { return location; }
+    std::string_view getEmployeeName() const { return employeeName; }
+    double getLoanAmount() const { return loanAmount; }
+    bool isLoanApproved() const { return loanApproved; }
+    double getBalance() const { return balance; }
+};
+
+// Linha de uma listagem de tarefas; o texto aponta para a arena do ResultSet que a contém
+struct TaskRow {
+    int id;
+    std::string_view description;
+    bool completed;
+    std::string_view companyNipc;
+    time_t createdAt;
+    time_t completedAt;
+
+    int getId() const { return id; }
+    std::string_view getDescription() const { return description; }
+    bool isCompleted() const { return completed; }
+    std::string_view getCompanyNipc() const { return companyNipc; }
+    time_t getCreatedAt() const { return createdAt; }
+    time_t getCompletedAt() const { return completedAt; }
+};
+
+// Resultado de uma consulta em massa. As linhas e o texto copiado com copy() ficam numa
+// única arena (monotonic_buffer_resource): nada é libertado linha a linha, e tudo é
+// devolvido de uma vez por clear() ou pelo destrutor. Os string_view das linhas só são
+// válidos enquanto o ResultSet existir e não for limpo.
+template <typename Row>
+class ResultSet {
+public:
+    explicit ResultSet(size_t initialBytes = 64 * 1024) : arena(initialBytes), rows(&arena) {}
+    ResultSet(const ResultSet&) = delete;
+    ResultSet& operator=(const ResultSet&) = delete;
+
+    // Copia texto para a arena
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) return std::string_view();
+        char* data = static_cast<char*>(arena.allocate(text.size(), 1));
+        std::memcpy(data, text.data(), text.size());
+        return std::string_view(data, text.size());
+    }
+
+    template <typename... Args>
+    Row& emplace_back(Args&&... args) { return rows.emplace_back(std::forward<Args>(args)...); }
+
+    void reserve(size_t count) { rows.reserve(count); }
+    void clear() {
+        rows = std::pmr::vector<Row>(&arena);
+        arena.release();
+    }
+
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+    Row& operator[](size_t index) { return rows[index]; }
+    const Row& operator[](size_t index) const { return rows[index]; }
+    Row& back() { return rows.back(); }
+    typename std::pmr::vector<Row>::const_iterator begin() const { return rows.begin(); }
+    typename std::pmr::vector<Row>::const_iterator end() const { return rows.end(); }
+
+private:
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::vector<Row> rows;
+};
+
+using CompanyResultSet = ResultSet<CompanyRow>;
+using TaskResultSet = ResultSet<TaskRow>;
+
+#endif // RESULT_SET_H
@@ -0,0 +1,84 @@
+#include "StringPool.h"
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+StringPool& StringPool::shared() {
+    static StringPool pool;
+    return pool;
+}
+
+StringPool::StringPool() : count(0), blockUsed(kBlockSize), bytes(0) {
+    for (auto& segment : segments) segment.store(nullptr, std::memory_order_relaxed);
+    intern("");
+}
+
+StringPool::~StringPool() {
+    for (auto& segment : segments) delete[] segment.load(std::memory_order_relaxed);
+}
+
+// Copia o texto para o bloco atual; strings maiores que um bloco ficam num bloco próprio
+const char* StringPool::store(std::string_view value) {
+    if (value.size() > kBlockSize / 4) {
+        blocks.emplace_back(new char[value.size()]);
+        std::memcpy(blocks.back().get(), value.data(), value.size());
+        return blocks.back().get();
+    }
+    if (blockUsed + value.size() > kBlockSize) {
+        blocks.emplace_back(new char[kBlockSize]);
+        blockUsed = 0;
+    }
+    char* destination = blocks.back().get() + blockUsed;
+    std::memcpy(destination, value.data(), value.size());
+    blockUsed += value.size();
+    return destination;
+}
+
+uint32_t StringPool::intern(std::string_view value) {
+    // Cache da thread com os últimos ids: os valores repetidos (locais, funcionários) não
+    // passam pelo mutex. O id guardado só é usado se lookup() devolver o mesmo texto.
+    struct CachedId {
+        const StringPool* pool;
+        uint32_t id;
+    };
+    thread_local CachedId cache[kThreadCacheSize] = {};
+    CachedId& cached = cache[std::hash<std::string_view>()(value) & (kThreadCacheSize - 1)];
+    if (cached.pool == this && !value.empty() && lookup(cached.id) == value) return cached.id;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = ids.find(value);
+    if (found != ids.end()) {
+        cached = CachedId{this, found->second};
+        return found->second;
+    }
+
+    uint32_t id = count.load(std::memory_order_relaxed);
+    uint32_t segmentIndex = id >> kSegmentBits;
+    if (segmentIndex >= kMaxSegments) {
+        throw std::length_error("StringPool: limite de strings internadas atingido");
+    }
+    Entry* segment = segments[segmentIndex].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new Entry[kSegmentSize];
+        segments[segmentIndex].store(segment, std::memory_order_release);
+    }
+
+    const char* data = value.empty() ? "" : store(value);
+    segment[id & (kSegmentSize - 1)] = Entry{data, static_cast<uint32_t>(value.size())};
+    ids.emplace(std::string_view(data, value.size()), id);
+    bytes += value.size();
+    count.store(id + 1, std::memory_order_release);
+    cached = CachedId{this, id};
+    return id;
+}
+
+std::string_view StringPool::lookup(uint32_t id) const {
+    if (id >= count.load(std::memory_order_acquire)) return std::string_view();
+    const Entry& entry = segments[id >> kSegmentBits].load(std::memory_order_acquire)[id & (kSegmentSize - 1)];
+    return std::string_view(entry.data, entry.size);
+}
+
+size_t StringPool::storedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
@@ -0,0 +1,57 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Conjunto de strings internadas, identificadas por ids de 32 bits. Cada valor distinto é
+// guardado uma única vez e nunca é removido, pelo que os string_view devolvidos por
+// lookup() são válidos até ao fim do programa.
+//
+// intern() usa um mutex, exceto quando o valor está na pequena cache da thread; lookup()
+// não usa locks (os ids são publicados por segmentos de tamanho fixo que nunca mudam de
+// endereço). O id 0 é sempre a string vazia.
+class StringPool {
+public:
+    static StringPool& shared();
+
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    uint32_t intern(std::string_view value);
+    std::string_view lookup(uint32_t id) const;
+    size_t size() const { return count.load(std::memory_order_acquire); }
+    // Bytes ocupados pelo texto das strings internadas
+    size_t storedBytes() const;
+
+private:
+    struct Entry {
+        const char* data;
+        uint32_t size;
+    };
+    static const uint32_t kSegmentBits = 12;
+    static const uint32_t kSegmentSize = 1u << kSegmentBits;
+    static const uint32_t kMaxSegments = 1u << 14;
+    static const size_t kBlockSize = 64 * 1024;
+    static const size_t kThreadCacheSize = 64;
+
+    const char* store(std::string_view value);
+
+    std::atomic<Entry*> segments[kMaxSegments];
+    std::atomic<uint32_t> count;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed;
+    size_t bytes;
+};
+
+#endif // STRING_POOL_H
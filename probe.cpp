@@ -0,0 +1,90 @@
+#include "probe.h"
+
+#ifdef BANK_PROBES
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace probe {
+
+namespace {
+
+// Nomes das sondas e totais das threads já terminadas. O relatório é escrito no destrutor,
+// que corre depois dos destrutores thread_local da thread principal.
+struct Registry {
+    std::mutex mutex;
+    std::vector<const char*> names{"(outras sondas)"};
+    Counter totals[kMaxSites] = {};
+    uint64_t startTicks = now();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    ~Registry() { report(); }
+    void report();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct LocalCounters {
+    Counter counters[kMaxSites] = {};
+
+    ~LocalCounters() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (int i = 0; i < kMaxSites; i++) {
+            reg.totals[i].calls += counters[i].calls;
+            reg.totals[i].cycles += counters[i].cycles;
+        }
+    }
+};
+
+void Registry::report() {
+    std::vector<int> order;
+    for (int i = 0; i < static_cast<int>(names.size()); i++) {
+        if (totals[i].calls > 0) order.push_back(i);
+    }
+    if (order.empty()) return;
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return totals[a].cycles > totals[b].cycles; });
+
+    // Ciclos por nanossegundo medidos ao longo da execução, para converter as médias
+    double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+    double ticksPerNs = elapsedNs > 0 ? (now() - startTicks) / elapsedNs : 1.0;
+
+    std::fprintf(stderr, "\n=== Sondas (BANK_PROBES) ===\n");
+    std::fprintf(stderr, "%-32s %12s %14s %14s %10s\n", "Sonda", "Chamadas", "Mciclos", "Ciclos/cham.", "ns/cham.");
+    for (int i : order) {
+        const Counter& total = totals[i];
+        double perCall = static_cast<double>(total.cycles) / total.calls;
+        std::fprintf(stderr, "%-32s %12llu %14.1f %14.1f %10.1f\n", names[i],
+                     static_cast<unsigned long long>(total.calls), total.cycles / 1e6, perCall,
+                     ticksPerNs > 0 ? perCall / ticksPerNs : 0.0);
+    }
+}
+
+} // namespace
+
+int registerSite(const char* name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 1; i < reg.names.size(); i++) {
+        if (std::strcmp(reg.names[i], name) == 0) return static_cast<int>(i);
+    }
+    if (reg.names.size() == static_cast<size_t>(kMaxSites)) return 0;
+    reg.names.push_back(name);
+    return static_cast<int>(reg.names.size() - 1);
+}
+
+Counter* localCounters() {
+    thread_local LocalCounters local;
+    return local.counters;
+}
+
+} // namespace probe
+
+#endif // BANK_PROBES
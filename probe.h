@@ -0,0 +1,81 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+// Sondas de tempo para ciclos quentes (linhas de uma consulta, parcelas de um plano).
+// Só são compiladas com a opção BANK_PROBES do CMake; sem ela as macros abaixo não geram
+// código nenhum.
+//
+//   while (sqlite3_step(stmt) == SQLITE_ROW) {
+//       PROBE_SCOPE("getAllCompanies.row");
+//       ...
+//   }
+//
+// Cada sonda soma chamadas e ciclos (rdtsc; noutras arquiteturas, nanossegundos) em
+// contadores da thread, sem locks. Os contadores de cada thread juntam-se aos totais quando
+// ela termina, e o relatório é escrito no stderr à saída do programa. Sondas com o mesmo
+// nome partilham os contadores.
+
+#ifdef BANK_PROBES
+
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace probe {
+
+const int kMaxSites = 256;
+
+struct Counter {
+    uint64_t calls;
+    uint64_t cycles;
+};
+
+// Índice dos contadores da sonda com este nome (criado na primeira chamada)
+int registerSite(const char* name);
+// Contadores da thread atual, indexados por registerSite
+Counter* localCounters();
+
+inline uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+class Scope {
+public:
+    explicit Scope(int site) : counter(localCounters() + site), start(now()) {}
+    ~Scope() {
+        counter->cycles += now() - start;
+        counter->calls++;
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Counter* counter;
+    uint64_t start;
+};
+
+} // namespace probe
+
+#define PROBE_CONCAT_INNER(a, b) a##b
+#define PROBE_CONCAT(a, b) PROBE_CONCAT_INNER(a, b)
+#define PROBE_SCOPE(name)                                                                  \
+    static const int PROBE_CONCAT(probeSite, __LINE__) = ::probe::registerSite(name);      \
+    ::probe::Scope PROBE_CONCAT(probeScope, __LINE__)(PROBE_CONCAT(probeSite, __LINE__))
+
+#else
+
+#define PROBE_SCOPE(name) ((void)0)
+
+#endif // BANK_PROBES
+
+#endif // PROBE_H
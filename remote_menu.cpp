@@ -0,0 +1,190 @@
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "daemon/BankClient.h"
+#include "remote_menu.h"
+
+namespace {
+
+double readAmount(const char* prompt) {
+    double amount;
+    std::cout << prompt;
+    while (!(std::cin >> amount) || amount <= 0) {
+        std::cout << "Valor inválido. Digite novamente: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cin.ignore();
+    return amount;
+}
+
+int readInstallmentCount() {
+    int months;
+    std::cout << "Número de parcelas (1-360): ";
+    while (!(std::cin >> months) || months < 1 || months > 360) {
+        std::cout << "Valor inválido. Digite novamente: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cin.ignore();
+    return months;
+}
+
+// Mensagem para os estados de erro comuns a todas as operações
+void reportFailure(protocol::Status status, const BankClient& client) {
+    if (!client.isConnected()) {
+        std::cout << "\nA ligação ao bank_daemon foi interrompida.\n";
+    } else if (status == protocol::Status::NotFound) {
+        std::cout << "\nEmpresa não encontrada!\n";
+    } else {
+        std::cout << "\nO servidor recusou a operação.\n";
+    }
+}
+
+// Pede o NIPC ou nome e procura a empresa; devolve false (já com a mensagem) se falhar
+bool askCompany(BankClient& client, Company& company) {
+    std::string input;
+    std::cout << "NIPC ou Nome da empresa: ";
+    std::getline(std::cin, input);
+    protocol::Status status = client.findCompany(input, company);
+    if (status != protocol::Status::Ok) {
+        reportFailure(status, client);
+        return false;
+    }
+    return true;
+}
+
+void checkBalance(BankClient& client) {
+    std::cout << "\n=== Consultar Saldo ===\n\n";
+    Company company;
+    if (!askCompany(client, company)) return;
+    std::cout << "\nEmpresa: " << company.getName() << "\nSaldo atual: R$ " << std::fixed
+              << std::setprecision(2) << company.getBalance() << "\n";
+}
+
+void deposit(BankClient& client) {
+    std::cout << "\n=== Depositar Dinheiro ===\n\n";
+    Company company;
+    if (!askCompany(client, company)) return;
+    double amount = readAmount("Valor a depositar: R$ ");
+    double balance;
+    protocol::Status status = client.deposit(std::string(company.getNIPC()), amount, balance);
+    if (status != protocol::Status::Ok) {
+        reportFailure(status, client);
+        return;
+    }
+    std::cout << "\nDepósito realizado com sucesso!\nNovo saldo: R$ " << std::fixed << std::setprecision(2)
+              << balance << "\n";
+}
+
+void payment(BankClient& client) {
+    std::cout << "\n=== Fazer Pagamento ===\n\n";
+    Company company;
+    if (!askCompany(client, company)) return;
+    std::cout << "Saldo atual: R$ " << std::fixed << std::setprecision(2) << company.getBalance() << "\n";
+    if (company.getBalance() >= 0) {
+        std::cout << "\nA empresa não possui dívida para pagar!\n";
+        return;
+    }
+    // O servidor limita o pagamento à dívida no momento em que o executa
+    double amount = readAmount("Valor do pagamento (limitado à dívida): R$ ");
+    double paid, balance;
+    protocol::Status status = client.pay(std::string(company.getNIPC()), amount, paid, balance);
+    if (status == protocol::Status::Rejected) {
+        std::cout << "\nA empresa não possui dívida para pagar!\n";
+        return;
+    }
+    if (status != protocol::Status::Ok) {
+        reportFailure(status, client);
+        return;
+    }
+    std::cout << "\nPagamento realizado com sucesso!\nValor pago: R$ " << std::fixed << std::setprecision(2)
+              << paid << "\nNovo saldo: R$ " << balance << "\n";
+}
+
+void addLoan(BankClient& client) {
+    std::cout << "\n=== Novo Empréstimo (empresa cadastrada) ===\n\n";
+    Company company;
+    if (!askCompany(client, company)) return;
+    double amount = readAmount("Valor do novo empréstimo: ");
+    int months = readInstallmentCount();
+    double balance;
+    protocol::Status status = client.addLoan(std::string(company.getNIPC()), amount, months, balance);
+    if (status != protocol::Status::Ok) {
+        if (status == protocol::Status::Failed && client.isConnected()) {
+            std::cout << "\nErro ao registrar empréstimo; o saldo não foi alterado.\n";
+        } else {
+            reportFailure(status, client);
+        }
+        return;
+    }
+    std::cout << "\nNovo empréstimo registrado para a empresa!\nNovo saldo: R$ " << std::fixed
+              << std::setprecision(2) << balance << "\n";
+}
+
+void addTask(BankClient& client) {
+    std::cout << "\n=== Nova Tarefa ===\n\n";
+    Company company;
+    if (!askCompany(client, company)) return;
+    std::string description;
+    std::cout << "Descrição: ";
+    std::getline(std::cin, description);
+    protocol::Status status = client.createTask(std::string(company.getNIPC()), description);
+    if (status != protocol::Status::Ok) {
+        reportFailure(status, client);
+        return;
+    }
+    std::cout << "\nTarefa adicionada com sucesso!\n";
+}
+
+void showSummary(BankClient& client) {
+    double totalLent, totalReceived, overallBalance;
+    protocol::Status status = client.getReport(totalLent, totalReceived, overallBalance);
+    if (status != protocol::Status::Ok) {
+        reportFailure(status, client);
+        return;
+    }
+    std::cout << "\n--- Resumo Financeiro ---\n";
+    std::cout << "Total emprestado: R$ " << std::fixed << std::setprecision(2) << totalLent << "\n";
+    std::cout << "Total recebido:   R$ " << std::fixed << std::setprecision(2) << totalReceived << "\n";
+    std::cout << "Saldo geral:      R$ " << std::fixed << std::setprecision(2) << overallBalance << "\n";
+}
+
+} // namespace
+
+int runRemoteMenu(const std::string& socketPath) {
+    // Um servidor que termina a meio de um pedido não deve derrubar o menu
+    std::signal(SIGPIPE, SIG_IGN);
+    BankClient client(socketPath);
+    if (!client.isConnected()) {
+        std::cerr << "Não foi possível ligar a " << socketPath << " (o bank_daemon está em execução?)\n";
+        return 1;
+    }
+    while (client.isConnected()) {
+        std::cout << "\n=== Sistema Bancário (bank_daemon) ===\n";
+        std::cout << "1. Consultar saldo (por NIPC ou nome)\n";
+        std::cout << "2. Depositar dinheiro (por NIPC ou nome)\n";
+        std::cout << "3. Fazer pagamento (por NIPC ou nome)\n";
+        std::cout << "4. Novo empréstimo (empresa cadastrada)\n";
+        std::cout << "5. Nova tarefa\n";
+        std::cout << "6. Resumo financeiro\n";
+        std::cout << "0. Sair\n";
+        std::cout << "Escolha uma opção: ";
+        int choice;
+        if (!(std::cin >> choice)) return 0;
+        std::cin.ignore();
+        switch (choice) {
+            case 1: checkBalance(client); break;
+            case 2: deposit(client); break;
+            case 3: payment(client); break;
+            case 4: addLoan(client); break;
+            case 5: addTask(client); break;
+            case 6: showSummary(client); break;
+            case 0: return 0;
+            default: std::cout << "\nOpção inválida!\n";
+        }
+    }
+    return 1;
+}
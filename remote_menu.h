@@ -0,0 +1,11 @@
+#ifndef REMOTE_MENU_H
+#define REMOTE_MENU_H
+
+#include <string>
+
+// Menu do bank_system como cliente do bank_daemon (bank_system --daemon [socket]): as
+// consultas e operações de balcão seguem pelo socket e o processo não abre o banco, pelo
+// que não disputa os locks com o servidor. Só em sistemas POSIX.
+int runRemoteMenu(const std::string& socketPath);
+
+#endif // REMOTE_MENU_H
@@ -0,0 +1,212 @@
+#include "table_renderer.h"
+#include <charconv>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Tamanho a partir do qual o buffer é escrito
+const size_t kFlushSize = 256 * 1024;
+
+#ifdef _WIN32
+const char* kDefaultPager = "more";
+#else
+const char* kDefaultPager = "less -FRX";
+void (*previousSigpipe)(int) = SIG_DFL;
+#endif
+
+bool stdoutIsTerminal() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+size_t terminalRows() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return static_cast<size_t>(info.srWindow.Bottom - info.srWindow.Top + 1);
+    }
+#else
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0) {
+        return size.ws_row;
+    }
+#endif
+    return 24;
+}
+
+void writeTwoDigits(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+} // namespace
+
+size_t displayWidth(std::string_view text) {
+    size_t width = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char byte = static_cast<unsigned char>(text[i]);
+        if ((byte & 0xC0) == 0x80) continue;  // byte de continuação
+        // U+0300..U+036F em UTF-8: 0xCC 0x80 a 0xCD 0xAF
+        if (i + 1 < text.size()) {
+            unsigned char next = static_cast<unsigned char>(text[i + 1]);
+            if (byte == 0xCC || (byte == 0xCD && next <= 0xAF)) continue;
+        }
+        width++;
+    }
+    return width;
+}
+
+void DateFormatter::format(time_t value, char* out) {
+    if (value < dayStart || value >= dayEnd) {
+        std::tm local = *std::localtime(&value);
+        time_t secondsOfDay = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+        int isDst = local.tm_isdst;
+        writeTwoDigits(day, local.tm_mday);
+        day[2] = '/';
+        writeTwoDigits(day + 3, local.tm_mon + 1);
+        day[5] = '/';
+        int year = local.tm_year + 1900;
+        writeTwoDigits(day + 6, year / 100 % 100);
+        writeTwoDigits(day + 8, year % 100);
+        day[10] = ' ';
+
+        // Só guarda o dia se não houver mudança de hora até ao fim dele
+        dayStart = value - secondsOfDay;
+        dayEnd = dayStart + 86400;
+        time_t lastSecond = dayEnd - 1;
+        if (std::localtime(&dayStart)->tm_isdst != isDst || std::localtime(&lastSecond)->tm_isdst != isDst) {
+            std::memcpy(out, day, sizeof(day));
+            writeTwoDigits(out + 11, local.tm_hour);
+            out[13] = ':';
+            writeTwoDigits(out + 14, local.tm_min);
+            dayStart = dayEnd = 0;
+            return;
+        }
+    }
+    int seconds = static_cast<int>(value - dayStart);
+    std::memcpy(out, day, sizeof(day));
+    writeTwoDigits(out + 11, seconds / 3600);
+    out[13] = ':';
+    writeTwoDigits(out + 14, seconds / 60 % 60);
+}
+
+TableRenderer::TableRenderer(const std::vector<TableColumn>& columns, size_t rowCount, const char* separator)
+    : columns(columns), separator(separator), column(0), out(stdout), paged(false), failed(false), finished(false) {
+    buffer.reserve(kFlushSize + 4096);
+    if (rowCount + 3 > terminalRows() && stdoutIsTerminal()) {
+        const char* command = std::getenv("PAGER");
+        if (!command || !*command) command = kDefaultPager;
+        std::fflush(stdout);
+#ifdef _WIN32
+        FILE* pager = _popen(command, "w");
+#else
+        FILE* pager = popen(command, "w");
+#endif
+        if (pager) {
+            out = pager;
+            paged = true;
+#ifndef _WIN32
+            // Sair do paginador antes do fim fecha o pipe; as escritas seguintes falham sem terminar o programa
+            previousSigpipe = std::signal(SIGPIPE, SIG_IGN);
+#endif
+        }
+    }
+}
+
+TableRenderer::~TableRenderer() {
+    finish();
+}
+
+void TableRenderer::cell(std::string_view value, size_t width) {
+    if (column > 0) buffer += separator;
+    const TableColumn& spec = columns[column < columns.size() ? column : columns.size() - 1];
+    size_t target = static_cast<size_t>(spec.width);
+    size_t padding = width < target ? target - width : 0;
+    bool last = column + 1 >= columns.size();
+    if (spec.alignRight) {
+        buffer.append(padding, ' ');
+        buffer += value;
+    } else {
+        buffer += value;
+        if (!last) buffer.append(padding, ' ');
+    }
+    column++;
+}
+
+void TableRenderer::header() {
+    size_t total = 0;
+    for (const auto& spec : columns) {
+        cell(spec.title, displayWidth(spec.title));
+        total += static_cast<size_t>(spec.width);
+    }
+    total += separator.size() * (columns.empty() ? 0 : columns.size() - 1);
+    endRow();
+    buffer.append(total, '-');
+    buffer += '\n';
+}
+
+void TableRenderer::text(std::string_view value) {
+    cell(value, displayWidth(value));
+}
+
+void TableRenderer::number(double value, int precision) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    size_t size = result.ec == std::errc() ? static_cast<size_t>(result.ptr - digits) : 0;
+    cell(std::string_view(digits, size), size);
+}
+
+void TableRenderer::integer(long long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    size_t size = static_cast<size_t>(result.ptr - digits);
+    cell(std::string_view(digits, size), size);
+}
+
+void TableRenderer::date(time_t value) {
+    char formatted[DateFormatter::kSize];
+    dates.format(value, formatted);
+    cell(std::string_view(formatted, sizeof(formatted)), sizeof(formatted));
+}
+
+void TableRenderer::endRow() {
+    buffer += '\n';
+    column = 0;
+    if (buffer.size() >= kFlushSize) write();
+}
+
+void TableRenderer::write() {
+    if (!failed && !buffer.empty()) {
+        failed = std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size();
+    }
+    buffer.clear();
+}
+
+void TableRenderer::finish() {
+    if (finished) return;
+    finished = true;
+    write();
+    if (paged) {
+#ifdef _WIN32
+        _pclose(out);
+#else
+        pclose(out);
+        std::signal(SIGPIPE, previousSigpipe);
+#endif
+        out = stdout;
+    } else {
+        std::fflush(out);
+    }
+}
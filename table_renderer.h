@@ -0,0 +1,74 @@
+#ifndef TABLE_RENDERER_H
+#define TABLE_RENDERER_H
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Coluna de uma tabela de texto: título, largura em colunas do terminal e alinhamento
+struct TableColumn {
+    const char* title;
+    int width;
+    bool alignRight;
+};
+
+// Largura de um texto UTF-8 no terminal: uma coluna por carácter, nenhuma para os acentos
+// combinantes (U+0300 a U+036F)
+size_t displayWidth(std::string_view text);
+
+// Formata datas como "dd/mm/aaaa hh:mm" na hora local. Guarda o último dia formatado, para
+// que datas seguidas do mesmo dia não chamem localtime (dias com mudança de hora não são
+// guardados).
+class DateFormatter {
+public:
+    static const size_t kSize = 16;
+
+    DateFormatter() : dayStart(0), dayEnd(0), day() {}
+    // Escreve kSize caracteres em out, sem terminador
+    void format(time_t value, char* out);
+
+private:
+    time_t dayStart;
+    time_t dayEnd;
+    char day[11];
+};
+
+// Tabela de texto formatada num buffer grande e escrita em blocos, sem iostream por campo.
+// As células de cada linha são acrescentadas pela ordem das colunas e endRow() termina a linha.
+// Se a tabela tiver mais linhas do que o terminal e a saída for um terminal, o resultado
+// passa pelo paginador ($PAGER, ou less/more).
+class TableRenderer {
+public:
+    TableRenderer(const std::vector<TableColumn>& columns, size_t rowCount, const char* separator = "");
+    ~TableRenderer();
+    TableRenderer(const TableRenderer&) = delete;
+    TableRenderer& operator=(const TableRenderer&) = delete;
+
+    // Títulos e linha de traços
+    void header();
+    void text(std::string_view value);
+    void number(double value, int precision = 2);
+    void integer(long long value);
+    void date(time_t value);
+    void endRow();
+    // Escreve o que falta e espera pelo paginador
+    void finish();
+
+private:
+    void cell(std::string_view value, size_t width);
+    void write();
+
+    std::vector<TableColumn> columns;
+    std::string separator;
+    std::string buffer;
+    size_t column;
+    FILE* out;
+    bool paged;
+    bool failed;
+    bool finished;
+    DateFormatter dates;
+};
+
+#endif // TABLE_RENDERER_H
@@ -1,11 +1,11 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <iomanip>
-#include <ctime>
+#include "models/ResultSet.h"
 #include "models/Task.h"
 #include "database/DatabaseManager.h"
 #include "task_list.h"
+#include "table_renderer.h"
 
 void printHeader() {
     std::cout << "\n=== Gerenciamento de Tarefas ===\n\n";
@@ -21,37 +21,37 @@ void printMenu() {
     std::cout << "Escolha uma opção: ";
 }
 
-void printTask(const Task& task) {
-    std::cout << std::setw(4) << task.getId() << " | ";
-    std::cout << std::setw(10) << (task.isCompleted() ? "Concluída" : "Pendente") << " | ";
-    std::cout << std::setw(40) << task.getDescription() << " | ";
-    
-    // Converte timestamp para string legível
-    char timeStr[20];
-    time_t taskTime = task.isCompleted() ? task.getCompletedAt() : task.getCreatedAt();
-    std::tm* tm = std::localtime(&taskTime);
-    std::strftime(timeStr, sizeof(timeStr), "%d/%m/%Y %H:%M", tm);
-    
-    std::cout << timeStr << " | ";
-    std::cout << task.getCompanyNipc() << "\n";
-}
+// Colunas da listagem de tarefas
+const std::vector<TableColumn> kTaskColumns = {
+    {"ID", 4, true},
+    {"Status", 10, false},
+    {"Descrição", 40, false},
+    {"Data", 16, false},
+    {"NIPC", 9, false},
+};
 
-void listAllTasks(DatabaseManager& dbManager) {
-    std::cout << "\n=== Lista de Todas as Tarefas ===\n\n";
-    std::cout << std::setw(4) << "ID" << " | ";
-    std::cout << std::setw(10) << "Status" << " | ";
-    std::cout << std::setw(40) << "Descrição" << " | ";
-    std::cout << std::setw(16) << "Data" << " | ";
-    std::cout << "NIPC\n";
-    std::cout << std::string(80, '-') << "\n";
-    
-    auto tasks = dbManager.getAllTasks();
+void printTasks(const TaskResultSet& tasks) {
+    TableRenderer table(kTaskColumns, tasks.size(), " | ");
+    table.header();
     for (const auto& task : tasks) {
-        printTask(task);
+        table.integer(task.getId());
+        table.text(task.isCompleted() ? "Concluída" : "Pendente");
+        table.text(task.getDescription());
+        table.date(task.isCompleted() ? task.getCompletedAt() : task.getCreatedAt());
+        table.text(task.getCompanyNipc());
+        table.endRow();
     }
+    table.finish();
     std::cout << "\n";
 }
 
+void listAllTasks(DatabaseManager& dbManager) {
+    std::cout << "\n=== Lista de Todas as Tarefas ===\n\n";
+    TaskResultSet tasks;
+    dbManager.getAllTasks(tasks);
+    printTasks(tasks);
+}
+
 void listCompanyTasks(DatabaseManager& dbManager) {
     std::string nipc;
     std::cout << "\nDigite o NIPC da empresa: ";
@@ -59,18 +59,9 @@ void listCompanyTasks(DatabaseManager& dbManager) {
     std::getline(std::cin, nipc);
     
     std::cout << "\n=== Tarefas da Empresa " << nipc << " ===\n\n";
-    std::cout << std::setw(4) << "ID" << " | ";
-    std::cout << std::setw(10) << "Status" << " | ";
-    std::cout << std::setw(40) << "Descrição" << " | ";
-    std::cout << std::setw(16) << "Data" << " | ";
-    std::cout << "NIPC\n";
-    std::cout << std::string(80, '-') << "\n";
-    
-    auto tasks = dbManager.getCompanyTasks(nipc);
-    for (const auto& task : tasks) {
-        printTask(task);
-    }
-    std::cout << "\n";
+    TaskResultSet tasks;
+    dbManager.getCompanyTasks(nipc, tasks);
+    printTasks(tasks);
 }
 
 void addNewTask(DatabaseManager& dbManager) {
@@ -96,7 +87,8 @@ void toggleTaskStatus(DatabaseManager& dbManager) {
     std::cout << "\nDigite o ID da tarefa: ";
     std::cin >> taskId;
     
-    auto tasks = dbManager.getAllTasks();
+    TaskResultSet tasks;
+    dbManager.getAllTasks(tasks);
     for (const auto& task : tasks) {
         if (task.getId() == taskId) {
             if (dbManager.updateTaskStatus(taskId, !task.isCompleted())) {
@@ -122,8 +114,7 @@ void deleteTask(DatabaseManager& dbManager) {
     }
 }
 
-void taskManagement() {
-    DatabaseManager dbManager("database/bank.db");
+void taskManagement(DatabaseManager& dbManager) {
     int choice;
     
     do {
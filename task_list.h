@@ -1,6 +1,10 @@
 #ifndef TASK_LIST_H
 #define TASK_LIST_H
 
-void taskManagement();
+class DatabaseManager;
+
+// Menu de tarefas sobre a conexão de quem chama (a mesma do menu principal, para que o
+// perfil escolhido, incluindo o modo em memória, valha também para as tarefas)
+void taskManagement(DatabaseManager& dbManager);
 
 #endif // TASK_LIST_H 
\ No newline at end of file
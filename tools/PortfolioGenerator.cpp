@@ -0,0 +1,356 @@
+#include "PortfolioGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "database/DatabaseManager.h"
+#include "models/Nipc.h"
+
+namespace {
+
+const char* kLocations[] = {
+    "Lisboa", "Porto", "Braga", "Coimbra", "Aveiro", "Faro", "Setúbal", "Funchal",
+    "Leiria", "Viseu", "Évora", "Guimarães", "Ponta Delgada", "Viana do Castelo", "Santarém", "Vila Real",
+    "Bragança", "Castelo Branco", "Guarda", "Portalegre", "Beja", "Matosinhos", "Amadora", "Sintra"
+};
+const char* kEmployees[] = {
+    "Ana Silva", "Bruno Costa", "Carla Sousa", "Diogo Ferreira", "Eva Martins", "Filipe Santos",
+    "Gonçalo Pereira", "Helena Rodrigues", "Inês Almeida", "João Carvalho", "Luísa Gomes", "Miguel Lopes"
+};
+const char* kTaskDescriptions[] = {
+    "Analisar documentação", "Confirmar garantias", "Contactar cliente", "Rever plano de pagamento",
+    "Atualizar dados cadastrais", "Enviar contrato", "Verificar comprovativo de pagamento"
+};
+const double kRates[] = {0.05, 0.08, 0.12};
+
+// Gerador determinístico: std::mt19937_64 tem saída definida pela norma, ao contrário
+// das distribuições da biblioteca, que por isso são implementadas aqui.
+class Random {
+public:
+    explicit Random(unsigned long long seed) : engine(seed) {}
+
+    double uniform() {
+        return (engine() >> 11) * (1.0 / 9007199254740992.0);
+    }
+    long long below(long long bound) {
+        return static_cast<long long>(engine() % static_cast<unsigned long long>(bound));
+    }
+    double normal() {
+        double u1 = uniform();
+        double u2 = uniform();
+        return std::sqrt(-2.0 * std::log(1.0 - u1)) * std::cos(6.283185307179586 * u2);
+    }
+    double exponential(double mean) {
+        return -mean * std::log(1.0 - uniform());
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+// Amostragem de Zipf sobre k categorias por tabela acumulada
+class ZipfTable {
+public:
+    ZipfTable(size_t count, double exponent) : cumulative(count) {
+        double total = 0.0;
+        for (size_t k = 0; k < count; k++) {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+            cumulative[k] = total;
+        }
+        for (double& value : cumulative) value /= total;
+    }
+    size_t sample(Random& random) const {
+        auto it = std::upper_bound(cumulative.begin(), cumulative.end(), random.uniform());
+        return std::min(static_cast<size_t>(it - cumulative.begin()), cumulative.size() - 1);
+    }
+
+private:
+    std::vector<double> cumulative;
+};
+
+// Dias desde 1970-01-01 para uma data civil (algoritmo de H. Hinnant)
+long long daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+void civilFromDays(long long z, int& y, int& m, int& d) {
+    z += 719468;
+    const long long era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+void writeDigits(char* out, int value, int width) {
+    for (int i = width - 1; i >= 0; i--) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+// Formata um instante Unix como "AAAA-MM-DD HH:MM:SS" (formato de CURRENT_TIMESTAMP)
+void formatTimestamp(long long epochSeconds, char* out) {
+    long long days = epochSeconds / 86400;
+    int secondOfDay = static_cast<int>(epochSeconds % 86400);
+    int y, m, d;
+    civilFromDays(days, y, m, d);
+    writeDigits(out, y, 4);
+    out[4] = '-';
+    writeDigits(out + 5, m, 2);
+    out[7] = '-';
+    writeDigits(out + 8, d, 2);
+    out[10] = ' ';
+    writeDigits(out + 11, secondOfDay / 3600, 2);
+    out[13] = ':';
+    writeDigits(out + 14, secondOfDay / 60 % 60, 2);
+    out[16] = ':';
+    writeDigits(out + 17, secondOfDay % 60, 2);
+    out[19] = '\0';
+}
+
+bool parseIsoDate(const std::string& date, long long& days) {
+    int y, m, d;
+    if (std::sscanf(date.c_str(), "%4d-%2d-%2d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+        return false;
+    }
+    days = daysFromCivil(y, m, d);
+    return true;
+}
+
+bool exec(sqlite3* db, const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "Erro ao executar SQL: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+// Remove índices secundários e gatilhos das tabelas carregadas e apaga a versão do
+// esquema, para que o DatabaseManager os volte a criar ao reabrir o banco
+bool dropSecondaryObjects(sqlite3* db) {
+    const char* sql = "SELECT type, name FROM sqlite_master "
+                      "WHERE type IN ('index', 'trigger') AND tbl_name IN ('companies', 'tasks') AND sql IS NOT NULL;";
+    std::vector<std::string> statements;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        statements.push_back((type == "index" ? "DROP INDEX \"" : "DROP TRIGGER \"") + name + "\";");
+    }
+    sqlite3_finalize(stmt);
+
+    for (const auto& statement : statements) {
+        if (!exec(db, statement.c_str())) return false;
+    }
+    return exec(db, "PRAGMA user_version = 0;");
+}
+
+// Agregados de originação por dia do histórico, acumulados durante a carga
+struct DailyRollup {
+    long long loanCount = 0;
+    double loanVolume = 0.0;
+    long long defaultCount = 0;
+};
+
+bool loadCompanies(sqlite3* db, const PortfolioOptions& options, Random& random, long long endDay,
+                   std::vector<DailyRollup>& rollups) {
+    // A empresa de índice i fica com o id i + 1, a que as tarefas se ligam
+    const char* sql = "INSERT INTO companies (name, nipc, location, employee_name, loan_amount, loan_approved, "
+                      "balance, created_at, deleted, interest_rate, id) VALUES (?, ?, ?, ?, ?, ?, ?, ?, 0, ?, ?);";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar carga de empresas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    const size_t locationCount = sizeof(kLocations) / sizeof(kLocations[0]);
+    const size_t employeeCount = sizeof(kEmployees) / sizeof(kEmployees[0]);
+    ZipfTable locations(locationCount, 1.1);
+    ZipfTable employees(employeeCount, 0.8);
+    long long firstDay = endDay - options.historyDays + 1;
+    char createdAt[20];
+    bool success = true;
+
+    for (long long i = 0; i < options.companies && success; i++) {
+        std::string name = portfolioCompanyName(i);
+
+        // Valores com cauda longa: log-normal com mediana de 20 mil euros
+        double amount = std::round(20000.0 * std::exp(1.0 * random.normal()) * 100.0) / 100.0;
+        amount = std::min(std::max(amount, 500.0), 2000000.0);
+        double balance = random.uniform() < options.delinquentShare
+                       ? -std::round(amount * (0.05 + 0.95 * random.uniform()) * 100.0) / 100.0
+                       : 0.0;
+        long long dayIndex = random.below(options.historyDays);
+        formatTimestamp((firstDay + dayIndex) * 86400 + 8 * 3600 + random.below(11 * 3600), createdAt);
+        DailyRollup& rollup = rollups[dayIndex];
+        rollup.loanCount++;
+        rollup.loanVolume += amount;
+        rollup.defaultCount += balance < 0 ? 1 : 0;
+
+        sqlite3_bind_text(stmt, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, portfolioNipcValue(i));
+        sqlite3_bind_text(stmt, 3, kLocations[locations.sample(random)], -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, kEmployees[employees.sample(random)], -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 5, amount);
+        sqlite3_bind_int(stmt, 6, amount <= 100000.0 ? 1 : 0);
+        sqlite3_bind_double(stmt, 7, balance);
+        sqlite3_bind_text(stmt, 8, createdAt, 19, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 9, kRates[random.below(3)]);
+        sqlite3_bind_int64(stmt, 10, i + 1);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            std::cerr << "Erro ao inserir empresa: " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+// Grava os agregados diários e mensais que os gatilhos de companies manteriam;
+// com eles preenchidos o DatabaseManager não precisa de os recalcular ao reabrir
+bool writeRollups(sqlite3* db, const PortfolioOptions& options, long long endDay, const std::vector<DailyRollup>& rollups) {
+    const char* sql = "INSERT INTO loan_rollup_daily (day, loan_count, loan_volume, default_count) VALUES (?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar agregados: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    long long firstDay = endDay - options.historyDays + 1;
+    char timestamp[20];
+    bool success = true;
+    for (size_t i = 0; i < rollups.size() && success; i++) {
+        if (rollups[i].loanCount == 0) continue;
+        formatTimestamp((firstDay + static_cast<long long>(i)) * 86400, timestamp);
+        sqlite3_bind_text(stmt, 1, timestamp, 10, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, rollups[i].loanCount);
+        sqlite3_bind_double(stmt, 3, rollups[i].loanVolume);
+        sqlite3_bind_int64(stmt, 4, rollups[i].defaultCount);
+        success = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    return success && exec(db, "INSERT INTO loan_rollup_monthly (month, loan_count, loan_volume, default_count) "
+                               "SELECT substr(day, 1, 7), SUM(loan_count), SUM(loan_volume), SUM(default_count) "
+                               "FROM loan_rollup_daily GROUP BY 1;");
+}
+
+bool loadTasks(sqlite3* db, const PortfolioOptions& options, Random& random, long long endDay) {
+    if (options.tasks <= 0 || options.companies <= 0) return true;
+
+    const char* sql = "INSERT INTO tasks (description, completed, company_id, created_at, completed_at) "
+                      "VALUES (?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Erro ao preparar carga de tarefas: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    const long long descriptionCount = sizeof(kTaskDescriptions) / sizeof(kTaskDescriptions[0]);
+    long long firstSecond = (endDay - options.historyDays + 1) * 86400;
+    long long historySeconds = static_cast<long long>(options.historyDays) * 86400;
+    bool success = true;
+
+    for (long long i = 0; i < options.tasks && success; i++) {
+        long long companyId = random.below(options.companies) + 1;
+        long long createdAt = firstSecond + random.below(historySeconds);
+        bool completed = random.uniform() < options.taskCompletionShare;
+        // Tempo de conclusão exponencial, com média de três dias
+        long long completedAt = completed ? createdAt + 60 + static_cast<long long>(random.exponential(3 * 86400.0)) : 0;
+
+        sqlite3_bind_text(stmt, 1, kTaskDescriptions[random.below(descriptionCount)], -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 2, completed ? 1 : 0);
+        sqlite3_bind_int64(stmt, 3, companyId);
+        sqlite3_bind_int64(stmt, 4, createdAt);
+        sqlite3_bind_int64(stmt, 5, completedAt);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            std::cerr << "Erro ao inserir tarefa: " << sqlite3_errmsg(db) << std::endl;
+            success = false;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+} // namespace
+
+// NIPC de pessoa coletiva (começa por 5) com dígito de controlo módulo 11
+long long portfolioNipcValue(long long index) {
+    long long base = 50000000 + index;
+    return base * 10 + nipcCheckDigit(base);
+}
+
+std::string portfolioNipc(long long index) {
+    return formatNipc(portfolioNipcValue(index));
+}
+
+std::string portfolioCompanyName(long long index) {
+    return "Empresa " + std::to_string(index) + " Lda";
+}
+
+bool generatePortfolio(const std::string& path, const PortfolioOptions& options) {
+    long long endDay;
+    if (!parseIsoDate(options.endDate, endDay) || options.historyDays <= 0 || options.companies < 0
+        || options.companies > 49999999) {
+        std::cerr << "Parâmetros da carteira inválidos" << std::endl;
+        return false;
+    }
+
+    {
+        // Cria o esquema pelo caminho normal da aplicação
+        DatabaseManager schema(path);
+        if (!schema.isConnectedToDatabase()) return false;
+    }
+
+    sqlite3* db;
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "Erro ao abrir banco de dados: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    // Carga em massa: sem diário nem fsync, numa única transação; se falhar, o arquivo
+    // deve ser descartado
+    Random random(options.seed);
+    std::vector<DailyRollup> rollups(options.historyDays);
+    bool success = exec(db, "PRAGMA journal_mode = OFF;"
+                            "PRAGMA synchronous = OFF;"
+                            "PRAGMA locking_mode = EXCLUSIVE;"
+                            "PRAGMA temp_store = MEMORY;"
+                            "PRAGMA cache_size = -262144;")
+                && exec(db, "BEGIN;")
+                && dropSecondaryObjects(db)
+                && loadCompanies(db, options, random, endDay, rollups)
+                && writeRollups(db, options, endDay, rollups)
+                && loadTasks(db, options, random, endDay)
+                && exec(db, "COMMIT;");
+    sqlite3_close(db);
+    if (!success) return false;
+
+    // Reabre pelo DatabaseManager para recriar índices e gatilhos
+    DatabaseManager finish(path);
+    return finish.isConnectedToDatabase();
+}
@@ -0,0 +1,30 @@
+#ifndef PORTFOLIO_GENERATOR_H
+#define PORTFOLIO_GENERATOR_H
+
+#include <string>
+
+// Parâmetros da carteira sintética
+struct PortfolioOptions {
+    long long companies = 10000;
+    long long tasks = 20000;
+    unsigned long long seed = 42;
+    // Fração das empresas com saldo devedor (inadimplentes)
+    double delinquentShare = 0.15;
+    // Fração das tarefas já concluídas
+    double taskCompletionShare = 0.6;
+    // Os empréstimos são distribuídos pelos historyDays dias que terminam em endDate
+    int historyDays = 3 * 365;
+    std::string endDate = "2025-12-31";
+};
+
+// Cria em `path` um banco novo com a carteira descrita em `options`.
+// O mesmo conjunto de opções gera sempre os mesmos dados.
+bool generatePortfolio(const std::string& path, const PortfolioOptions& options);
+
+// NIPC e nome da empresa de índice `index` (0 .. companies-1) na carteira gerada;
+// a empresa fica com o id index + 1
+long long portfolioNipcValue(long long index);
+std::string portfolioNipc(long long index);
+std::string portfolioCompanyName(long long index);
+
+#endif // PORTFOLIO_GENERATOR_H
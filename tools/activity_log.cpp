@@ -0,0 +1,195 @@
+/**
+ * @file activity_log.cpp
+ * @brief Lê e filtra o registo de atividades (database/activity.log)
+ * @details Uso: bank_activity_log [--file database/activity.log] [--nipc N] [--type tipo]
+ *                                 [--task id] [--since AAAA-MM-DD] [--until AAAA-MM-DD]
+ *                                 [--summary]
+ *          Escreve um registo por linha, ou com --summary as contagens e totais por tipo.
+ *          Os tipos são os de activityTypeName (movimento, emprestimo, tarefa_criada, ...).
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "database/ActivityLog.h"
+
+namespace {
+
+struct Filter {
+    long long nipc = 0;
+    uint16_t type = 0;
+    long long task = 0;
+    int64_t sinceUs = 0;
+    int64_t untilUs = INT64_MAX;
+};
+
+// Meia-noite (hora local) de AAAA-MM-DD, mais `days` dias, em microssegundos desde 1970
+bool parseDate(const std::string& text, int days, int64_t& microseconds) {
+    std::tm date = {};
+    if (std::sscanf(text.c_str(), "%4d-%2d-%2d", &date.tm_year, &date.tm_mon, &date.tm_mday) != 3) return false;
+    date.tm_year -= 1900;
+    date.tm_mon -= 1;
+    date.tm_mday += days;
+    date.tm_isdst = -1;
+    std::time_t seconds = std::mktime(&date);
+    if (seconds == -1) return false;
+    microseconds = static_cast<int64_t>(seconds) * 1000000;
+    return true;
+}
+
+bool matches(const ActivityRecord& record, const Filter& filter) {
+    if (record.timeUs < filter.sinceUs || record.timeUs >= filter.untilUs) return false;
+    if (filter.nipc != 0 && record.nipc != filter.nipc) return false;
+    if (filter.type != 0 && record.type != filter.type) return false;
+    if (filter.task != 0 && (record.reference != filter.task || record.type < static_cast<uint16_t>(ActivityType::TaskCreated)
+                             || record.type > static_cast<uint16_t>(ActivityType::TaskDeleted))) {
+        return false;
+    }
+    return true;
+}
+
+// Formata a data e hora; a parte dos segundos só é recalculada quando o segundo muda
+class TimeFormatter {
+public:
+    const char* format(int64_t timeUs) {
+        std::time_t seconds = static_cast<std::time_t>(timeUs / 1000000);
+        if (seconds != cachedSecond) {
+            cachedSecond = seconds;
+            std::strftime(secondText, sizeof(secondText), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+        }
+        std::snprintf(text, sizeof(text), "%s.%06d", secondText, static_cast<int>(timeUs % 1000000));
+        return text;
+    }
+
+private:
+    std::time_t cachedSecond = -1;
+    char secondText[32] = {};
+    char text[48] = {};
+};
+
+void printRecord(const ActivityRecord& record, TimeFormatter& formatter) {
+    const char* name = activityTypeName(record.type);
+    std::printf("%s  %-16s", formatter.format(record.timeUs), name ? name : "?");
+    if (record.nipc != 0) {
+        std::printf("  %09lld", static_cast<long long>(record.nipc));
+    } else {
+        std::printf("  %9s", "-");
+    }
+    std::printf("  %14.2f  %8lld", record.amount, static_cast<long long>(record.reference));
+    if (record.type == static_cast<uint16_t>(ActivityType::TaskCreated)
+        || record.type == static_cast<uint16_t>(ActivityType::TaskStatusChanged)) {
+        std::printf("  %s", (record.flags & kActivityTaskCompleted) ? "concluída" : "pendente");
+    }
+    std::printf("  pid %u\n", record.processId);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = kActivityLogPath;
+    Filter filter;
+    bool summary = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--summary") {
+            summary = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << arg << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--file") {
+            path = value;
+        } else if (arg == "--nipc") {
+            filter.nipc = std::atoll(value.c_str());
+        } else if (arg == "--type") {
+            if (!activityTypeFromName(value, filter.type)) {
+                std::cerr << "Tipo desconhecido: " << value << "\n";
+                return 1;
+            }
+        } else if (arg == "--task") {
+            filter.task = std::atoll(value.c_str());
+        } else if (arg == "--since") {
+            if (!parseDate(value, 0, filter.sinceUs)) {
+                std::cerr << "Data inválida: " << value << "\n";
+                return 1;
+            }
+        } else if (arg == "--until") {
+            // Inclui o próprio dia
+            if (!parseDate(value, 1, filter.untilUs)) {
+                std::cerr << "Data inválida: " << value << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Opção desconhecida: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Erro ao abrir " << path << "\n";
+        return 1;
+    }
+    ActivityLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1
+        || std::string(header.magic, sizeof(header.magic)) != std::string(kActivityLogMagic, sizeof(kActivityLogMagic))
+        || header.recordSize != sizeof(ActivityRecord)) {
+        std::cerr << path << " não é um registo de atividades desta versão\n";
+        std::fclose(file);
+        return 1;
+    }
+
+    // Leitura em blocos grandes e saída com buffer grande: o custo fica no disco e no filtro
+    static char outputBuffer[1 << 20];
+    std::setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    std::vector<ActivityRecord> block(1 << 16);
+    TimeFormatter formatter;
+    const int kTypeSlots = 64;
+    unsigned long long counts[kTypeSlots] = {};
+    double amounts[kTypeSlots] = {};
+    unsigned long long total = 0;
+    unsigned long long shown = 0;
+
+    size_t count;
+    while ((count = std::fread(block.data(), sizeof(ActivityRecord), block.size(), file)) > 0) {
+        total += count;
+        for (size_t i = 0; i < count; i++) {
+            const ActivityRecord& record = block[i];
+            if (!matches(record, filter)) continue;
+            shown++;
+            if (summary) {
+                int slot = record.type < kTypeSlots ? record.type : 0;
+                counts[slot]++;
+                amounts[slot] += record.amount;
+            } else {
+                printRecord(record, formatter);
+            }
+        }
+    }
+    // Um registo incompleto no fim (escrita interrompida) é ignorado
+    bool truncated = std::ftell(file) != static_cast<long>(sizeof(header) + total * sizeof(ActivityRecord));
+    std::fclose(file);
+
+    if (summary) {
+        std::printf("%-16s %12s %18s\n", "tipo", "registos", "valor");
+        for (int type = 0; type < kTypeSlots; type++) {
+            if (counts[type] == 0) continue;
+            const char* name = activityTypeName(static_cast<uint16_t>(type));
+            std::printf("%-16s %12llu %18.2f\n", name ? name : "?", counts[type], amounts[type]);
+        }
+    }
+    std::fflush(stdout);
+    std::cerr << shown << " de " << total << " registos\n";
+    if (truncated) {
+        std::cerr << "Aviso: registo incompleto no fim de " << path << " ignorado\n";
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file generate_portfolio.cpp
+ * @brief Gera um banco de dados com uma carteira sintética de empréstimos
+ * @details Uso: generate_portfolio [--companies N] [--tasks M] [--seed S]
+ *                                  [--delinquent 0.15] [--end-date AAAA-MM-DD]
+ *                                  [--output database/bank.db] [--force]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "PortfolioGenerator.h"
+
+int main(int argc, char* argv[]) {
+    PortfolioOptions options;
+    std::string outputPath = "database/bank.db";
+    bool force = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--force") {
+            force = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << arg << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--companies") {
+            options.companies = std::atoll(value.c_str());
+        } else if (arg == "--tasks") {
+            options.tasks = std::atoll(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--delinquent") {
+            options.delinquentShare = std::atof(value.c_str());
+        } else if (arg == "--end-date") {
+            options.endDate = value;
+        } else if (arg == "--output") {
+            outputPath = value;
+        } else {
+            std::cerr << "Opção desconhecida: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (std::filesystem::exists(outputPath)) {
+        if (!force) {
+            std::cerr << outputPath << " já existe; use --force para substituir.\n";
+            return 1;
+        }
+        std::filesystem::remove(outputPath);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!generatePortfolio(outputPath, options)) {
+        std::cerr << "Erro ao gerar carteira.\n";
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long rows = options.companies + options.tasks;
+    std::cout << "Carteira gerada em " << outputPath << ": " << options.companies << " empresas, "
+              << options.tasks << " tarefas em " << std::fixed << std::setprecision(2) << seconds << " s";
+    if (seconds > 0) {
+        std::cout << " (" << std::setprecision(0) << rows / seconds << " linhas/s)";
+    }
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "trace.h"
+
+#ifdef BANK_TRACE
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    int depth;
+};
+
+// Buffer circular de uma thread. O mutex só é disputado durante o dump.
+struct RingBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+    unsigned threadId = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+const std::chrono::steady_clock::time_point kProcessStart = std::chrono::steady_clock::now();
+
+// O registry mantém o buffer vivo depois do fim da thread, para que os eventos entrem no dump
+RingBuffer& localBuffer() {
+    thread_local std::shared_ptr<RingBuffer> buffer = [] {
+        auto created = std::make_shared<RingBuffer>();
+        created->events.resize(kRingCapacity);
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->threadId = static_cast<unsigned>(reg.buffers.size() + 1);
+        reg.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+}
+
+} // namespace
+
+uint64_t nowNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kProcessStart).count());
+}
+
+int& currentDepth() {
+    thread_local int depth = 0;
+    return depth;
+}
+
+void record(const char* name, uint64_t startNs, uint64_t endNs, int depth) {
+    RingBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.next] = Event{name, startNs, endNs - startNs, depth};
+    if (++buffer.next == kRingCapacity) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+bool dump(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> registryLock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        std::vector<Event> events;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            if (buffer->wrapped) {
+                events.assign(buffer->events.begin() + buffer->next, buffer->events.end());
+            }
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + buffer->next);
+        }
+        // Spans terminam de dentro para fora; o visualizador prefere os pais primeiro
+        std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.startNs != b.startNs ? a.startNs < b.startNs : a.depth < b.depth;
+        });
+
+        for (const Event& event : events) {
+            out << (first ? "" : ",\n") << "{\"name\": \"";
+            writeEscaped(out, event.name);
+            out << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+                << ", \"ts\": " << event.startNs / 1000 << "." << event.startNs % 1000 / 100
+                << ", \"dur\": " << event.durationNs / 1000 << "." << event.durationNs % 1000 / 100
+                << ", \"args\": {\"depth\": " << event.depth << "}}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+} // namespace trace
+
+#endif // BANK_TRACE
@@ -0,0 +1,62 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Registo de intervalos (spans) no formato trace-event do Chrome, para abrir no
+// Perfetto ou em chrome://tracing. Só é compilado com a opção BANK_TRACE do CMake;
+// sem ela as macros abaixo não geram código nenhum.
+//
+//   void depositMoney(...) {
+//       TRACE_SCOPE("depositMoney");
+//       ...
+//   }
+//   TRACE_DUMP("database/trace.json");
+
+#ifdef BANK_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace trace {
+
+// Eventos guardados por thread; quando o buffer enche, os mais antigos são substituídos
+const size_t kRingCapacity = 1 << 16;
+
+uint64_t nowNanoseconds();
+void record(const char* name, uint64_t startNs, uint64_t endNs, int depth);
+int& currentDepth();
+bool dump(const std::string& path);
+
+// Mede o tempo de vida do objeto; name deve ser um literal (só o ponteiro é guardado)
+class Span {
+public:
+    explicit Span(const char* name) : name(name), depth(currentDepth()++), start(nowNanoseconds()) {}
+    ~Span() {
+        uint64_t end = nowNanoseconds();
+        currentDepth()--;
+        record(name, start, end, depth);
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name;
+    int depth;
+    uint64_t start;
+};
+
+} // namespace trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ::trace::Span TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_DUMP(path) ::trace::dump(path)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_DUMP(path) ((void)0)
+
+#endif // BANK_TRACE
+
+#endif // TRACE_H
@@ -1,6 +1,9 @@
 /**
  * @file view_data.cpp
  * @brief Programa para visualização do histórico de empréstimos
+ * @details Uso: view_data [--snapshot arquivo.db]
+ *          Abre o banco uma única vez, só de leitura: os relatórios nunca pedem o lock de
+ *          escrita. Com --snapshot lê uma cópia do banco em modo imutável (sem locks).
  */
 
 #include <iostream>
@@ -14,6 +17,7 @@
 #endif
 #include "database/DatabaseManager.h"
 #include "models/Company.h"
+#include "table_renderer.h"
 #include "advanced_features.cpp"
 
 // Função para configurar o console para UTF-8
@@ -25,47 +29,44 @@ bool setupConsole() {
     #endif
 }
 
-// Função para exibir o cabeçalho da tabela
-void displayHeader() {
-    std::cout << std::left
-              << std::setw(20) << "Empresa"
-              << std::setw(20) << "Local"
-              << std::setw(20) << "Funcionário"
-              << std::setw(15) << "Valor (€)"
-              << std::setw(10) << "Status"
-              << "\n";
-    std::cout << std::string(85, '-') << "\n";
-}
+// Colunas da listagem de empresas
+const std::vector<TableColumn> kCompanyColumns = {
+    {"Empresa", 20, false},
+    {"Local", 20, false},
+    {"Funcionário", 20, false},
+    {"Valor (€)", 15, false},
+    {"Status", 10, false},
+};
 
-// Função para exibir os dados de uma empresa
-void displayCompany(const Company& company) {
-    std::cout << std::left
-              << std::setw(20) << company.getName()
-              << std::setw(20) << company.getLocation()
-              << std::setw(20) << company.getEmployeeName()
-              << std::fixed << std::setprecision(2)
-              << std::setw(15) << company.getLoanAmount()
-              << std::setw(10) << (company.isLoanApproved() ? "Aprovado" : "Reprovado")
-              << "\n";
+// Função para exibir a tabela de empresas
+void displayCompanies(const CompanyResultSet& companies) {
+    TableRenderer table(kCompanyColumns, companies.size());
+    table.header();
+    for (const auto& company : companies) {
+        table.text(company.getName());
+        table.text(company.getLocation());
+        table.text(company.getEmployeeName());
+        table.number(company.getLoanAmount());
+        table.text(company.isLoanApproved() ? "Aprovado" : "Reprovado");
+        table.endRow();
+    }
+    table.finish();
 }
 
-void displayLog() {
+void displayLog(DatabaseManager& dbManager) {
     std::cout << "\n=== Log de Empréstimos ===\n\n";
-    DatabaseManager dbManager("database/bank.db");
-    auto companies = dbManager.getAllCompanies();
+    CompanyResultSet companies;
+    dbManager.getAllCompanies(companies);
     
     if (companies.empty()) {
         std::cout << "Nenhum empréstimo registrado.\n";
         return;
     }
 
-    displayHeader();
-    for (const auto& company : companies) {
-        displayCompany(company);
-    }
+    displayCompanies(companies);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         // Configura o console para UTF-8
         if (!setupConsole()) {
@@ -73,6 +74,20 @@ int main() {
             return 1;
         }
 
+        std::string dbPath = "database/bank.db";
+        bool snapshot = false;
+        if (argc > 2 && std::string(argv[1]) == "--snapshot") {
+            dbPath = argv[2];
+            snapshot = true;
+        } else if (argc > 1) {
+            std::cerr << "Uso: view_data [--snapshot arquivo.db]\n";
+            return 1;
+        }
+        DatabaseManager dbManager(dbPath, readOnlyDatabaseOptions(snapshot));
+        if (!dbManager.isConnectedToDatabase()) {
+            return 1;
+        }
+
         while (true) {
             std::cout << "\n=== Sistema Bancário ===\n\n";
             std::cout << "1. Ver histórico de empréstimos\n";
@@ -85,27 +100,23 @@ int main() {
             std::cin >> choice;
             std::cin.ignore();
 
-            DatabaseManager dbManager("database/bank.db");
-
             switch (choice) {
                 case 1: {
                     std::cout << "\n=== Histórico de Empréstimos ===\n\n";
-                    auto companies = dbManager.getAllCompanies();
+                    CompanyResultSet companies;
+                    dbManager.getAllCompanies(companies);
                     if (companies.empty()) {
                         std::cout << "Nenhum registro encontrado.\n";
                     } else {
-                        displayHeader();
-                        for (const auto& company : companies) {
-                            displayCompany(company);
-                        }
+                        displayCompanies(companies);
                     }
                     break;
                 }
                 case 2:
-                    displayLog();
+                    displayLog(dbManager);
                     break;
                 case 3:
-                    showAdvancedMenu();
+                    showAdvancedMenu(dbManager);
                     break;
                 case 0:
                     std::cout << "\nSaindo...\n";